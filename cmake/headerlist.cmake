@@ -3,7 +3,19 @@ set(headers ${headers}
 	src/bindings.h
 	src/core.h
 	src/engine.h
+	src/eventfilter.h
+	src/expression.h
+	src/keymap.h
+	src/optimizer.h
+	src/papyrusvm.h
+	src/scheduler.h
+	src/script.h
+	src/scriptcontext.h
 	src/skse_events.h
 	src/sl_triggers.h
+	src/taskqueue.h
+    src/triggergate.h
     src/util.h
+    src/variables.h
+    src/workerpool.h
 )
\ No newline at end of file
@@ -1,8 +1,20 @@
 set(sources ${sources}
     src/core.cpp
     src/engine.cpp
+    src/eventfilter.cpp
+    src/expression.cpp
+    src/keymap.cpp
     src/main.cpp
+    src/optimizer.cpp
+    src/papyrusvm.cpp
+    src/scheduler.cpp
+    src/script.cpp
+    src/scriptcontext.cpp
     src/skse_events.cpp
     src/sl_triggers.cpp
+    src/taskqueue.cpp
+    src/triggergate.cpp
     src/util.cpp
+    src/variables.cpp
+    src/workerpool.cpp
 )
\ No newline at end of file
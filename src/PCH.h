@@ -7,23 +7,31 @@ using namespace std::literals;
 namespace fs = std::filesystem;
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <bitset>
 #include <charconv>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <coroutine>
 #include <cstdint>
+#include <deque>
 #include <format>
 #include <fstream>
 #include <functional>
 #include <future>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <ranges>
 #include <shared_mutex>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_set>
 #include <unordered_map>
 #include <variant>
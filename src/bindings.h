@@ -18,6 +18,35 @@ namespace SLT {
             virtual void RegisterFunctions(RE::BSScript::Internal::VirtualMachine* vm, std::string_view className) = 0;
         };
 
+        // How a native may be scheduled. Natives above MainThread are registered callable from
+        // tasklets, so the VM runs them on the calling thread instead of syncing to the next frame.
+        // The tier is the registrant's claim: IsValidTier only checks the signature carries no game
+        // objects, not that the state a PluginState native reaches is actually locked or atomic.
+        enum class ThreadSafety : std::uint8_t {
+            MainThread,  // touches game objects or unsynchronized state
+            PluginState, // only plugin-owned state behind its own locks, or the filesystem
+            Pure         // depends on nothing but its arguments
+        };
+
+        // Values Papyrus copies in and out of a native. Anything else (forms, references, active
+        // effects) is a live game object, which tasklet-callable natives must not be handed.
+        template<typename T>
+        struct IsTaskletSafeValue : std::bool_constant<std::is_arithmetic_v<T>> {};
+        template<>
+        struct IsTaskletSafeValue<void> : std::true_type {};
+        template<>
+        struct IsTaskletSafeValue<std::string> : std::true_type {};
+        template<>
+        struct IsTaskletSafeValue<std::string_view> : std::true_type {};
+        template<typename T>
+        struct IsTaskletSafeValue<std::vector<T>> : IsTaskletSafeValue<T> {};
+
+        template<ThreadSafety Safety, typename Return, typename... Args>
+        consteval bool IsValidTier() {
+            return Safety == ThreadSafety::MainThread ||
+                   (IsTaskletSafeValue<std::remove_cvref_t<Return>>::value && (IsTaskletSafeValue<std::remove_cvref_t<Args>>::value && ...));
+        }
+
         // Template-based registrar for clean registration
         template<typename T>
         class PapyrusRegistrar {
@@ -29,30 +58,35 @@ namespace SLT {
                 : vm_(vm), className_(className) {}
             
             // Static function registration
-            template<typename Return, typename... Args>
-            void RegisterStatic(std::string_view name, Return(*func)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, RE::StaticFunctionTag*, Args...), bool callableFromTasklets = false) {
+            template<ThreadSafety Safety = ThreadSafety::MainThread, typename Return, typename... Args>
+            void RegisterStatic(std::string_view name, Return(*func)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, RE::StaticFunctionTag*, Args...)) {
+                static_assert(IsValidTier<Safety, Return, Args...>(),
+                    "tasklet-callable natives may only take and return numbers, strings and arrays of those; register natives that handle game objects as ThreadSafety::MainThread");
                 auto wrapper = reinterpret_cast<Return(*)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, RE::StaticFunctionTag*, Args...)>(func);
-                vm_->RegisterFunction(name, className_, wrapper, callableFromTasklets);
+                vm_->RegisterFunction(name, className_, wrapper, Safety != ThreadSafety::MainThread);
             }
             
             // Static latent function registration
-            template<typename Return, typename... Args>
-            void RegisterStaticLatent(std::string_view name, RE::BSScript::LatentStatus(*func)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, RE::StaticFunctionTag*, Args...), bool callableFromTasklets = false) {
-                vm_->RegisterLatentFunction<Return>(name, className_, func, callableFromTasklets);
+            template<typename Return, ThreadSafety Safety = ThreadSafety::MainThread, typename... Args>
+            void RegisterStaticLatent(std::string_view name, RE::BSScript::LatentStatus(*func)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, RE::StaticFunctionTag*, Args...)) {
+                static_assert(IsValidTier<Safety, Return, Args...>(),
+                    "tasklet-callable natives may only take and return numbers, strings and arrays of those; register natives that handle game objects as ThreadSafety::MainThread");
+                vm_->RegisterLatentFunction<Return>(name, className_, func, Safety != ThreadSafety::MainThread);
             }
             
-            // Instance function registration (for future use)
+            // Instance function registration (for future use); the instance is a game object, so
+            // these always sync to the main thread
             template<typename Return, typename Instance, typename... Args>
-            void RegisterInstance(std::string_view name, Return(*func)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, Instance*, Args...), bool callableFromTasklets = false) {
+            void RegisterInstance(std::string_view name, Return(*func)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, Instance*, Args...)) {
                 auto wrapper = reinterpret_cast<Return(*)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, Instance*, Args...)>(func);
-                vm_->RegisterFunction(name, className_, wrapper, callableFromTasklets);
+                vm_->RegisterFunction(name, className_, wrapper, false);
             }
             
             // Instance latent function registration (for future use)
             template<typename Return, typename Instance, typename... Args>
-            void RegisterInstanceLatent(std::string_view name, Return(*func)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, Instance*, Args...), bool callableFromTasklets = false) {
+            void RegisterInstanceLatent(std::string_view name, Return(*func)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, Instance*, Args...)) {
                 auto wrapper = reinterpret_cast<Return(*)(RE::BSScript::Internal::VirtualMachine*, RE::VMStackID, Instance*, Args...)>(func);
-                vm_->RegisterLatentFunction(name, className_, wrapper, callableFromTasklets);
+                vm_->RegisterLatentFunction(name, className_, wrapper, false);
             }
         };
 
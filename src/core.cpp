@@ -1,4 +1,6 @@
 
+#include "taskqueue.h"
+
 namespace SLT {
 
 #pragma region Core basics
@@ -16,7 +18,8 @@ fs::path GetScriptfilePath(std::string_view scriptfilename) {
     return scriptfilepath;
 }
     
-SLTSessionId sessionId;
+// Read by GetSessionId, which tasklets may call, while the main thread regenerates it on load
+std::atomic<SLTSessionId> sessionId = 0;
 bool sessionIdGenerated = false;
 
 SLTSessionId GenerateNewSessionId(bool force) {
@@ -25,19 +28,38 @@ SLTSessionId GenerateNewSessionId(bool force) {
         static std::mt19937 engine(rd());
         static std::uniform_int_distribution<std::int32_t> dist(std::numeric_limits<std::int32_t>::min(),
                                                                 std::numeric_limits<std::int32_t>::max());
-        sessionId = dist(engine);
+        sessionId.store(dist(engine), std::memory_order_relaxed);
+        sessionIdGenerated = true;
     }
-    return sessionId;
+    return sessionId.load(std::memory_order_relaxed);
 }
 
 SLTSessionId GetSessionId() {
-    return sessionId;
+    return sessionId.load(std::memory_order_relaxed);
 }
 #pragma endregion
 
 #pragma region ScriptPoolManager
+RE::ActiveEffect* ScriptPoolManager::FindActiveEffect(RE::TESObjectREFR* ref, std::uint16_t effectId) {
+    auto* actor = ref ? ref->As<RE::Actor>() : nullptr;
+    auto* magicTarget = actor ? actor->AsMagicTarget() : nullptr;
+    auto* effects = magicTarget ? magicTarget->GetActiveEffectList() : nullptr;
+    if (!effects) {
+        return nullptr;
+    }
+    for (auto* effect : *effects) {
+        if (effect && effect->usUniqueID == effectId) {
+            return effect;
+        }
+    }
+    return nullptr;
+}
 
 bool ScriptPoolManager::ApplyScript(RE::Actor* target, std::string_view scriptName) {
+    return ApplyScript(target ? target->GetFormID() : 0, scriptName);
+}
+
+bool ScriptPoolManager::ApplyScript(RE::FormID target, std::string_view scriptName) {
     if (!target) {
         logger::error("Invalid caster or target for script application");
         return false;
@@ -59,9 +81,7 @@ bool ScriptPoolManager::ApplyScript(RE::Actor* target, std::string_view scriptNa
         }
         
         // Cast the spell
-        auto* magicCaster = target->GetMagicCaster(RE::MagicSystem::CastingSource::kInstant);
-        if (magicCaster) {
-            magicCaster->CastSpellImmediate(spell, false, target, 1.0f, false, 0.0f, target);
+        if (PapyrusVM::Get().CastSpell(target, spell)) {
             return true;
         } else {
             logger::error("Failed to get magic caster for script application");
@@ -72,5 +92,92 @@ bool ScriptPoolManager::ApplyScript(RE::Actor* target, std::string_view scriptNa
 
     return false;
 }
+
+std::vector<std::int32_t> ScriptPoolManager::ApplyScriptBatch(std::span<RE::Actor* const> targets, std::string_view scriptName) {
+    std::vector<RE::FormID> targetIds;
+    targetIds.reserve(targets.size());
+    for (auto* target : targets) {
+        targetIds.push_back(target ? target->GetFormID() : 0);
+    }
+    return ApplyScriptBatch(targetIds, scriptName);
+}
+
+std::vector<std::int32_t> ScriptPoolManager::ApplyScriptBatch(std::span<const RE::FormID> targets, std::string_view scriptName) {
+    std::vector<std::int32_t> codes(targets.size(), kBatchNoTarget);
+    std::vector<SlotReservation> reservations;
+    reservations.reserve(targets.size());
+
+    auto& vm = PapyrusVM::Get();
+    std::vector<RE::FormID> active;
+    {
+        std::lock_guard lock(reservationMutex);
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            auto targetId = targets[i];
+            active.clear();
+            if (!targetId || !vm.GetMagicEffects(targetId, active)) {
+                continue;
+            }
+
+            codes[i] = kBatchNoFreeSlot;
+            for (std::size_t slot = 0; slot < mgefPool.size() && slot < spellPool.size(); ++slot) {
+                // the reservation also keeps a target listed twice in one batch from getting the same slot
+                if (!IsActive(active, mgefPool[slot]) && !IsReservedLocked(targetId, slot)) {
+                    reservedSlots[targetId].push_back(slot);
+                    reservations.push_back({ targetId, slot });
+                    codes[i] = kBatchQueued;
+                    break;
+                }
+            }
+            if (codes[i] == kBatchNoFreeSlot) {
+                logger::warn("No available magic effects in pool for target {:08X}", targetId);
+            }
+        }
+    }
+
+    if (!reservations.empty()) {
+        MainThreadQueue::GetSingleton().Enqueue([this, reservations = std::move(reservations), scriptName = std::string(scriptName)]() {
+            CastReserved(reservations, scriptName);
+        });
+    }
+    return codes;
+}
+
+bool ScriptPoolManager::IsReservedLocked(RE::FormID targetId, std::size_t slot) const {
+    auto it = reservedSlots.find(targetId);
+    return it != reservedSlots.end() && std::ranges::find(it->second, slot) != it->second.end();
+}
+
+void ScriptPoolManager::CastReserved(const std::vector<SlotReservation>& reservations, const std::string& scriptName) {
+    std::size_t cast = 0;
+    for (const auto& reservation : reservations) {
+        // a target unloaded since the reservation fails the cast
+        try {
+            if (PapyrusVM::Get().CastSpell(reservation.targetId, spellPool[reservation.slot])) {
+                cast++;
+            }
+        } catch (...) {
+            logger::error("Unknown/unexpected exception casting batched script {}", scriptName);
+        }
+    }
+
+    {
+        // the casts above applied their effects, so GetMagicEffects reports these slots from here on
+        std::lock_guard lock(reservationMutex);
+        for (const auto& reservation : reservations) {
+            auto it = reservedSlots.find(reservation.targetId);
+            if (it == reservedSlots.end()) {
+                continue;
+            }
+            std::erase(it->second, reservation.slot);
+            if (it->second.empty()) {
+                reservedSlots.erase(it);
+            }
+        }
+    }
+
+    if (cast < reservations.size()) {
+        logger::warn("ApplyScriptBatch: {} of {} targets for {} could not be cast", reservations.size() - cast, reservations.size(), scriptName);
+    }
+}
 #pragma endregion
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "util.h"
+#include "papyrusvm.h"
 
 namespace SLT {
 
@@ -18,6 +19,11 @@ enum ScriptType {
 typedef std::uint32_t SKSEMessageType;
 typedef std::int32_t SLTSessionId;
 typedef std::int32_t ForgeHandle;
+typedef std::int32_t FrameHandle;
+typedef std::int32_t ContextHandle;
+typedef std::int32_t ChordId;
+typedef std::int32_t FilterId;
+typedef std::int32_t ScriptHandle;
 
 extern const std::string_view BASE_QUEST;
 extern const std::string_view BASE_AME;
@@ -61,7 +67,41 @@ public:
 
 #pragma region SmartComparator
 class SmartComparator {
+public:
+    using Value = std::variant<std::monostate, bool, std::int32_t, float, std::string, RE::TESForm*>;
+
+    // The SmartEquals native's rule, which scripts get for '==': if both sides read whole as
+    // floats they are equal within FLT_EPSILON, otherwise the text must match exactly
+    static bool Equals(std::string_view lhs, std::string_view rhs) {
+        float lhsFloat = 0.0f, rhsFloat = 0.0f;
+        if (ReadFloat(lhs, lhsFloat) && ReadFloat(rhs, rhsFloat)) {
+            return std::fabs(lhsFloat - rhsFloat) < FLT_EPSILON;
+        }
+        return lhs == rhs;
+    }
+
+    // Orders both sides as floats, read as Equals reads them; text that is not wholly a number is 0
+    static std::partial_ordering Compare(std::string_view lhs, std::string_view rhs) {
+        float lhsFloat = 0.0f, rhsFloat = 0.0f;
+        ReadFloat(lhs, lhsFloat);
+        ReadFloat(rhs, rhsFloat);
+        return lhsFloat <=> rhsFloat;
+    }
+
+    static bool Truthy(const Value& value) {
+        return std::visit([](const auto& v) { return IsTruthy(v); }, value);
+    }
+
 private:
+    static bool ReadFloat(std::string_view str, float& out) {
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), out);
+        if (ec != std::errc{} || ptr != str.data() + str.size()) {
+            out = 0.0f;
+            return false;
+        }
+        return true;
+    }
+
     template<typename T>
     static bool IsTruthy(const T& value) {
         if constexpr (std::is_same_v<T, std::monostate>) {
@@ -242,7 +282,7 @@ public:
         for (int i = 1; i <= 99; ++i) {
             std::string spellId = "slt_cmds" + std::to_string(i).insert(0, 2 - std::to_string(i).length(), '0');
             if (auto spell = RE::TESForm::LookupByEditorID<RE::SpellItem>(spellId)) {
-                spellPool.push_back(spell);
+                spellPool.push_back(spell->GetFormID());
                 highWaterMark = i;
                 lastSpellId = spellId;
             } else {
@@ -253,7 +293,7 @@ public:
         for (int i = 1; i <= highWaterMark; ++i) {
             std::string mgefId = "slt_cmd" + std::to_string(i).insert(0, 2 - std::to_string(i).length(), '0');
             if (auto mgef = RE::TESForm::LookupByEditorID<RE::EffectSetting>(mgefId)) {
-                mgefPool.push_back(mgef);
+                mgefPool.push_back(mgef->GetFormID());
             } else {
                 highWaterMark = i;
                 logger::warn("Failed to find magic effect: [{}]({})\n\
@@ -267,25 +307,51 @@ public:
                     spellPool.size(), mgefPool.size());
     }
 
-    RE::EffectSetting* FindAvailableMGEF(RE::Actor* target) {
-        if (!target) return nullptr;
-        
-        auto magicTarget = target->AsMagicTarget();
-        if (!magicTarget) return nullptr;
+    // Uses the given spell and effect form ids instead of the editor-ID lookups, for running
+    // against a FakePapyrusVM
+    void InitializePool(std::vector<RE::FormID> spells, std::vector<RE::FormID> mgefs) {
+        spells.resize(std::min(spells.size(), mgefs.size()));
+        mgefs.resize(spells.size());
+        spellPool = std::move(spells);
+        mgefPool = std::move(mgefs);
+    }
+
+    // Per-target result codes of ApplyScriptBatch
+    enum BatchStartCode : std::int32_t {
+        kBatchQueued = 1,
+        kBatchNoTarget = 0,
+        kBatchNoFreeSlot = -1,
+        kBatchScriptNotFound = -2
+    };
+
+    // The form id of a pool effect not active on target, or 0 if every slot is taken
+    RE::FormID FindAvailableMGEF(RE::FormID target) {
+        if (!target) return 0;
+        std::vector<RE::FormID> active;
+        if (!PapyrusVM::Get().GetMagicEffects(target, active)) return 0;
         
-        for (auto mgef : mgefPool) {
-            if (!magicTarget->HasMagicEffect(mgef)) {
-                return mgef;
+        std::lock_guard lock(reservationMutex);
+        for (std::size_t slot = 0; slot < mgefPool.size(); ++slot) {
+            // slots reserved by a batch still waiting on its cast are taken even though the effect isn't applied yet
+            if (!IsActive(active, mgefPool[slot]) && !IsReservedLocked(target, slot)) {
+                return mgefPool[slot];
             }
         }
         
-        logger::warn("No available magic effects in pool for target {}", 
-                    target->GetDisplayFullName());
-        return nullptr;
+        logger::warn("No available magic effects in pool for target {:08X}", target);
+        return 0;
     }
     
-    RE::SpellItem* FindSpellForMGEF(RE::EffectSetting* mgef) {
-        if (!mgef) return nullptr;
+    bool IsPoolEffect(const RE::EffectSetting* mgef) const {
+        return mgef && std::find(mgefPool.begin(), mgefPool.end(), mgef->GetFormID()) != mgefPool.end();
+    }
+
+    // The effect with the given unique id on ref, if ref is an actor still holding it
+    static RE::ActiveEffect* FindActiveEffect(RE::TESObjectREFR* ref, std::uint16_t effectId);
+
+    // The pool spell that applies mgef, or 0 if mgef is not a pool effect
+    RE::FormID FindSpellForMGEF(RE::FormID mgef) {
+        if (!mgef) return 0;
         
         auto it = std::find(mgefPool.begin(), mgefPool.end(), mgef);
         if (it != mgefPool.end()) {
@@ -295,14 +361,35 @@ public:
             }
         }
         
-        return nullptr;
+        return 0;
     }
     
+    bool ApplyScript(RE::FormID target, std::string_view scriptName);
     bool ApplyScript(RE::Actor* target, std::string_view scriptName);
 
+    // Reserves a pool slot on every target in one pass and casts them all from a single main-thread
+    // task. Returns a BatchStartCode per target, in order; form id 0 is kBatchNoTarget.
+    std::vector<std::int32_t> ApplyScriptBatch(std::span<const RE::FormID> targets, std::string_view scriptName);
+    std::vector<std::int32_t> ApplyScriptBatch(std::span<RE::Actor* const> targets, std::string_view scriptName);
+
 private:
-    std::vector<RE::SpellItem*> spellPool;
-    std::vector<RE::EffectSetting*> mgefPool;
+    struct SlotReservation {
+        RE::FormID targetId;
+        std::size_t slot;
+    };
+
+    std::vector<RE::FormID> spellPool;
+    std::vector<RE::FormID> mgefPool;
+
+    std::mutex reservationMutex;
+    std::unordered_map<RE::FormID, std::vector<std::size_t>> reservedSlots;
+
+    static bool IsActive(std::span<const RE::FormID> active, RE::FormID mgef) {
+        return std::ranges::find(active, mgef) != active.end();
+    }
+
+    bool IsReservedLocked(RE::FormID targetId, std::size_t slot) const;
+    void CastReserved(const std::vector<SlotReservation>& reservations, const std::string& scriptName);
     
     ScriptPoolManager() = default;
     ScriptPoolManager(const ScriptPoolManager&) = delete;
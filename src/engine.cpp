@@ -2,40 +2,65 @@
 
 namespace SLT {
     
+#pragma region TokenPool
+const RE::BSFixedString* TokenPool::Intern(std::string_view token) {
+    {
+        std::shared_lock lock(mutex);
+        if (auto it = pool.find(token); it != pool.end()) {
+            return &it->second;
+        }
+    }
+    std::unique_lock lock(mutex);
+    // map nodes do not move, so the address stays valid as the pool grows
+    auto [it, inserted] = pool.try_emplace(std::string(token), RE::BSFixedString(token));
+    return &it->second;
+}
+
+bool TokenPool::Contains(std::string_view token) const {
+    std::shared_lock lock(mutex);
+    return pool.contains(token);
+}
+
+std::size_t TokenPool::Size() const {
+    std::shared_lock lock(mutex);
+    return pool.size();
+}
+#pragma endregion
+
 #pragma region OperationRunner
 bool OperationRunner::RunOperationOnActor(RE::Actor* targetActor, 
                                          RE::ActiveEffect* cmdPrimary, 
-                                         const std::vector<RE::BSFixedString>& params) {
-    if (!cmdPrimary || !targetActor || params.empty()) {
-        logger::error("RunOperationOnActor: Invalid parameters cmdPrimary({}) targetActor({}) params.empty({})", !cmdPrimary, !targetActor, params.empty());
+                                         std::vector<PapyrusVM::Argument> params,
+                                         PapyrusVM::ResultCallback callback) {
+    if (!cmdPrimary || !targetActor) {
+        logger::error("RunOperationOnActor: Invalid parameters cmdPrimary({}) targetActor({})", !cmdPrimary, !targetActor);
         return false;
     }
-    
-    auto* vm = RE::BSScript::Internal::VirtualMachine::GetSingleton();
-    if (!vm) {
-        logger::error("RunOperationOnActor: Failed to get VM singleton");
+    return RunOperationOnActor(targetActor->GetFormID(), cmdPrimary->usUniqueID, std::move(params), std::move(callback));
+}
+
+bool OperationRunner::RunOperationOnActor(RE::FormID target,
+                                         std::uint16_t effectId,
+                                         std::vector<PapyrusVM::Argument> params,
+                                         PapyrusVM::ResultCallback callback) {
+    if (!target || params.empty()) {
+        logger::error("RunOperationOnActor: Invalid parameters target({:08X}) params.empty({})", target, params.empty());
         return false;
     }
     
-    auto cachedIt = FunctionLibrary::functionScriptCache.find(params[0].c_str());
+    auto cachedIt = FunctionLibrary::functionScriptCache.find(params[0].text);
     if (cachedIt == FunctionLibrary::functionScriptCache.end()) {
-        logger::error("RunOperationOnActor: Unable to find operation {} in function library cache", params[0].c_str());
+        logger::error("RunOperationOnActor: Unable to find operation {} in function library cache", params[0].text);
         return false;
     }
 
-    auto voidCallback = RE::BSTSmartPointer<RE::BSScript::IStackCallbackFunctor>{};
-    
-    auto* operationArgs = RE::MakeFunctionArguments(
-        static_cast<RE::Actor*>(targetActor), 
-        static_cast<RE::ActiveEffect*>(cmdPrimary),
-        static_cast<std::vector<RE::BSFixedString>>(params)
-    );
-    
-    auto& cachedScript = cachedIt->second;
-    bool success = vm->DispatchStaticCall(cachedScript, params[0], operationArgs, voidCallback);
+    // copied before params is moved into the call
+    const std::string operation = params[0].text;
+    bool success = PapyrusVM::Get().DispatchStaticCall(cachedIt->second, operation, target, effectId,
+                                                       std::move(params), std::move(callback));
     
     if (!success) {
-        logger::error("RunOperationOnActor: Failed to dispatch static call for operation {}", params[0].c_str());
+        logger::error("RunOperationOnActor: Failed to dispatch static call for operation {}", operation);
     }
     
     return success;
@@ -43,18 +68,25 @@ bool OperationRunner::RunOperationOnActor(RE::Actor* targetActor,
 
 bool OperationRunner::RunOperationOnActor(RE::Actor* targetActor, 
                                          RE::ActiveEffect* cmdPrimary, 
-                                         const std::vector<std::string>& params) {
+                                         std::vector<std::string> params,
+                                         PapyrusVM::ResultCallback callback) {
     if (params.empty()) {
         return false;
     }
     
-    std::vector<RE::BSFixedString> bsParams;
-    bsParams.reserve(params.size());
-    for (const auto& param : params) {
-        bsParams.emplace_back(param);
+    auto& pool = TokenPool::GetSingleton();
+    std::vector<PapyrusVM::Argument> args;
+    args.reserve(params.size());
+    // operation names come from a small fixed vocabulary, so they are worth pooling. Arguments
+    // may be any runtime value: those a script load already pooled reuse that entry, the rest
+    // are built fresh so the pool does not grow with every value passed through here.
+    args.push_back({ std::move(params[0]), true });
+    for (std::size_t i = 1; i < params.size(); ++i) {
+        const bool pooled = pool.Contains(params[i]);
+        args.push_back({ std::move(params[i]), pooled });
     }
     
-    return RunOperationOnActor(targetActor, cmdPrimary, bsParams);
+    return RunOperationOnActor(targetActor, cmdPrimary, std::move(args), std::move(callback));
 }
 #pragma endregion
 
@@ -140,68 +172,20 @@ bool FunctionLibrary::PrecacheLibraries() {
     } else {
         logger::info("{} libraries available, processing", g_FunctionLibraries.size());
     }
-    auto* vm = RE::BSScript::Internal::VirtualMachine::GetSingleton();
-    RE::BSTSmartPointer<RE::BSScript::ObjectTypeInfo> typeinfoptr;
+    auto& vm = PapyrusVM::Get();
+    std::vector<std::string> operations;
     for (const auto& scriptlib : g_FunctionLibraries) {
-        std::string& _scriptname = scriptlib->functionFile;
-
-        bool success = false;
-        try {
-            success = vm->GetScriptObjectType(_scriptname, typeinfoptr);
-        } catch (...) {
-            //logger::info("exception?"); // this never gets called
-        }
+        const std::string& _scriptname = scriptlib->functionFile;
 
-        if (!success) {
+        operations.clear();
+        if (!vm.GetOperationFunctions(_scriptname, operations)) {
             logger::info("PrecacheLibraries: ObjectTypeInfo unavailable");
             continue;
         }
 
-        success = false;
-
-        int numglobs = typeinfoptr->GetNumGlobalFuncs();
-        auto globiter = typeinfoptr->GetGlobalFuncIter();
-
-        for (int i = 0; i < numglobs; i++) {
-            auto libfunc = globiter[i].func;
-
-            RE::BSFixedString libfuncName = libfunc->GetName();
-
-            auto cachedIt = functionScriptCache.find(libfuncName.c_str());
-            if (cachedIt != functionScriptCache.end()) {
-                // cache hit, continue
-                continue;
-            }
-
-            if (libfunc->GetParamCount() != 3) {
-                //logger::info("param count rejection: need 3 has {}", libfunc->GetParamCount());
-                continue;
-            }
-
-            RE::BSFixedString paramName;
-            RE::BSScript::TypeInfo paramTypeInfo;
-
-            libfunc->GetParam(0, paramName, paramTypeInfo);
-
-            std::string Actor_name("Actor");
-            if (!paramTypeInfo.IsObject() && Actor_name != paramTypeInfo.TypeAsString()) {
-                continue;
-            }
-
-            libfunc->GetParam(1, paramName, paramTypeInfo);
-
-            std::string ActiveMagicEffect_name("ActiveMagicEffect");
-            if (!paramTypeInfo.IsObject() && ActiveMagicEffect_name != paramTypeInfo.TypeAsString()) {
-                continue;
-            }
-
-            libfunc->GetParam(2, paramName, paramTypeInfo);
-
-            if (paramTypeInfo.GetRawType() != RE::BSScript::TypeInfo::RawType::kStringArray) {
-                continue;
-            }
-
-            functionScriptCache[std::string(libfuncName)] = std::string(_scriptname.c_str());
+        // libraries are in priority order, so the first one to define an operation keeps it
+        for (auto& operation : operations) {
+            functionScriptCache.try_emplace(std::move(operation), _scriptname);
         }
     }
 
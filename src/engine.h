@@ -20,18 +20,79 @@ public:
 private:
     std::function<void()> onDone;
 };
+
+// As VoidCallbackFunctor, but hands the call's return value to the callback
+class ResultCallbackFunctor : public RE::BSScript::IStackCallbackFunctor {
+public:
+    explicit ResultCallbackFunctor(std::function<void(const RE::BSScript::Variable&)> callback)
+        : onDone(std::move(callback)) {}
+
+    void operator()(RE::BSScript::Variable result) override {
+        if (onDone) {
+            onDone(result);
+        }
+    }
+
+    void SetObject(const RE::BSTSmartPointer<RE::BSScript::Object>&) override {}
+
+private:
+    std::function<void(const RE::BSScript::Variable&)> onDone;
+};
+#pragma endregion
+
+#pragma region TokenPool
+// Script tokens as pre-built BSFixedStrings. Building a BSFixedString is a lookup in the game's
+// global string cache under its lock; tokens that never change are built once, when their script
+// loads, and each dispatch only copies the cached handle. Entries are never dropped, so pointers
+// into the pool stay valid for as long as a loaded script holds them.
+class TokenPool {
+public:
+    static TokenPool& GetSingleton() {
+        static TokenPool singleton;
+        return singleton;
+    }
+
+    const RE::BSFixedString* Intern(std::string_view token);
+    // True if token is already pooled; never adds it
+    bool Contains(std::string_view token) const;
+    std::size_t Size() const;
+
+private:
+    // transparent so lookups by string_view do not allocate
+    struct KeyHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, RE::BSFixedString, KeyHash, std::equal_to<>> pool;
+
+    TokenPool() = default;
+    TokenPool(const TokenPool&) = delete;
+    TokenPool& operator=(const TokenPool&) = delete;
+};
 #pragma endregion
 
 #pragma region OperationRunner
 class OperationRunner {
 public:
+    // params[0] is the operation name; the vector is moved into the call's arguments. effectId is
+    // the unique id of the active effect on target that the operation runs under.
+    static bool RunOperationOnActor(RE::FormID target,
+                                   std::uint16_t effectId,
+                                   std::vector<PapyrusVM::Argument> params,
+                                   PapyrusVM::ResultCallback callback = {});
+
     static bool RunOperationOnActor(RE::Actor* targetActor, 
                                    RE::ActiveEffect* cmdPrimary, 
-                                   const std::vector<RE::BSFixedString>& params);
+                                   std::vector<PapyrusVM::Argument> params,
+                                   PapyrusVM::ResultCallback callback = {});
     
+    // As above, for arguments that arrive as plain strings; each is moved into its argument
     static bool RunOperationOnActor(RE::Actor* targetActor, 
                                    RE::ActiveEffect* cmdPrimary, 
-                                   const std::vector<std::string>& params);
+                                   std::vector<std::string> params,
+                                   PapyrusVM::ResultCallback callback = {});
 };
 #pragma endregion
 
@@ -39,9 +100,12 @@ public:
 
 struct CaseInsensitiveHash {
     std::size_t operator()(const std::string& key) const {
-        std::string lower_key = key;
-        std::transform(lower_key.begin(), lower_key.end(), lower_key.begin(), ::tolower);
-        return std::hash<std::string>{}(lower_key);
+        // FNV-1a over the lowered characters; hashing must not allocate a lowered copy
+        std::size_t hash = 14695981039346656037ull;
+        for (unsigned char c : key) {
+            hash = (hash ^ static_cast<std::size_t>(std::tolower(c))) * 1099511628211ull;
+        }
+        return hash;
     }
 };
 
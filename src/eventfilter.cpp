@@ -0,0 +1,248 @@
+#include "eventfilter.h"
+
+namespace SLT {
+
+#pragma region GameEventFilter
+namespace {
+RE::FormID FormIDOf(const RE::TESObjectREFR* ref) {
+    return ref ? ref->GetFormID() : 0;
+}
+
+std::uint64_t WindowKey(FilterId filterId, RE::FormID subject) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(filterId)) << 32) | subject;
+}
+}
+
+void GameEventFilter::Install() {
+    auto* holder = RE::ScriptEventSourceHolder::GetSingleton();
+    if (!holder) {
+        logger::error("GameEventFilter: event source holder unavailable, filtered game events will not fire");
+        return;
+    }
+    holder->AddEventSink<RE::TESHitEvent>(this);
+    holder->AddEventSink<RE::TESCombatEvent>(this);
+    holder->AddEventSink<RE::TESEquipEvent>(this);
+    holder->AddEventSink<RE::TESContainerChangedEvent>(this);
+}
+
+FilterId GameEventFilter::Register(std::string_view eventName, const Criteria& criteria, const Delivery& delivery) {
+    if (eventName.empty() || criteria.kind < kHit || criteria.kind > kContainer) {
+        return INVALID_FILTER;
+    }
+
+    std::lock_guard lock(mutex);
+    const auto slot = Slot(criteria.kind);
+    const FilterId id = nextId++;
+    filters[slot].push_back(Filter{ id, std::string(eventName), criteria, Delivery{ std::max(delivery.windowSeconds, 0.0f), delivery.debounce } });
+    active[slot].store(static_cast<std::uint32_t>(filters[slot].size()), std::memory_order_release);
+    return id;
+}
+
+void GameEventFilter::Unregister(FilterId id) {
+    std::lock_guard lock(mutex);
+    for (std::size_t slot = 0; slot < kKindCount; ++slot) {
+        if (std::erase_if(filters[slot], [id](const Filter& filter) { return filter.id == id; }) > 0) {
+            active[slot].store(static_cast<std::uint32_t>(filters[slot].size()), std::memory_order_release);
+            DropWindowsLocked(id);
+            return;
+        }
+    }
+}
+
+bool GameEventFilter::SetDelivery(FilterId id, const Delivery& delivery) {
+    std::lock_guard lock(mutex);
+    for (auto& kindFilters : filters) {
+        for (auto& filter : kindFilters) {
+            if (filter.id == id) {
+                filter.delivery = Delivery{ std::max(delivery.windowSeconds, 0.0f), delivery.debounce };
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void GameEventFilter::Clear() {
+    std::lock_guard lock(mutex);
+    for (std::size_t slot = 0; slot < kKindCount; ++slot) {
+        filters[slot].clear();
+        active[slot].store(0, std::memory_order_release);
+    }
+    DropWindowsLocked(INVALID_FILTER);
+}
+
+void GameEventFilter::DropWindowsLocked(FilterId filterId) {
+    // windows still open are discarded, not delivered
+    std::erase_if(windows, [filterId](const auto& entry) {
+        if (filterId != INVALID_FILTER && entry.second.filterId != filterId) {
+            return false;
+        }
+        WaitScheduler::GetSingleton().Cancel(entry.second.timer);
+        return true;
+    });
+}
+
+GameEventFilter::Stats GameEventFilter::GetStats() const {
+    Stats stats{};
+    for (std::size_t slot = 0; slot < kKindCount; ++slot) {
+        stats.seen[slot] = seen[slot].load(std::memory_order_relaxed);
+        stats.forwarded[slot] = forwarded[slot].load(std::memory_order_relaxed);
+        stats.merged[slot] = merged[slot].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+bool GameEventFilter::IsActive(Kind kind) {
+    const auto slot = Slot(kind);
+    seen[slot].fetch_add(1, std::memory_order_relaxed);
+    return active[slot].load(std::memory_order_acquire) > 0;
+}
+
+bool GameEventFilter::Matches(const Criteria& criteria, const Observed& observed) {
+    if (criteria.subject && criteria.subject != observed.subject) return false;
+    if (criteria.other && criteria.other != observed.other) return false;
+    if (criteria.form && criteria.form != observed.form) return false;
+    if (criteria.state >= 0) {
+        // hit flags are a required mask, every other state an exact value
+        if (observed.kind == kHit ? (observed.state & criteria.state) != criteria.state : observed.state != criteria.state) {
+            return false;
+        }
+    }
+    // last: the only test that touches the reference
+    if (criteria.subjectKeyword && !(observed.subjectRef && observed.subjectRef->HasKeyword(criteria.subjectKeyword))) {
+        return false;
+    }
+    return true;
+}
+
+void GameEventFilter::Dispatch(std::span<const Observed> views) {
+    if (views.empty()) {
+        return;
+    }
+
+    std::vector<std::tuple<std::string, FilterId, const Observed*>> matched;
+    {
+        std::lock_guard lock(mutex);
+        for (const auto& filter : filters[Slot(views.front().kind)]) {
+            for (const auto& view : views) {
+                if (Matches(filter.criteria, view)) {
+                    if (filter.delivery.windowSeconds > 0.0f) {
+                        CoalesceLocked(filter, view);
+                    } else {
+                        matched.emplace_back(filter.eventName, filter.id, &view);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    for (const auto& [eventName, id, view] : matched) {
+        Send(eventName, id, *view, view->subjectRef, 1);
+    }
+}
+
+void GameEventFilter::CoalesceLocked(const Filter& filter, const Observed& observed) {
+    const auto now = SteadyClock::now();
+    const auto window = std::chrono::duration_cast<SteadyClock::duration>(std::chrono::duration<float>(filter.delivery.windowSeconds));
+    const auto key = WindowKey(filter.id, observed.subject);
+
+    if (auto it = windows.find(key); it != windows.end()) {
+        auto& open = it->second;
+        open.last = observed;
+        open.last.subjectRef = nullptr;
+        ++open.events;
+        if (filter.delivery.debounce) {
+            // the timer is not moved; when it fires early it re-arms for the remainder
+            open.deadline = now + window;
+        }
+        merged[Slot(observed.kind)].fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const auto serial = nextSerial++;
+    Window open{ serial, filter.eventName, filter.id, observed, 1, now + window, INVALID_TIMER };
+    // the reference is looked up again on delivery, it may be gone by then
+    open.last.subjectRef = nullptr;
+    open.timer = WaitScheduler::GetSingleton().ScheduleRealTime(filter.delivery.windowSeconds, [this, key, serial]() { FlushWindow(key, serial); });
+    windows.emplace(key, std::move(open));
+}
+
+void GameEventFilter::FlushWindow(std::uint64_t key, std::uint64_t serial) {
+    Window closed;
+    {
+        std::lock_guard lock(mutex);
+        auto it = windows.find(key);
+        if (it == windows.end() || it->second.serial != serial) {
+            return;
+        }
+        const auto remaining = it->second.deadline - SteadyClock::now();
+        if (remaining > SteadyClock::duration::zero()) {
+            it->second.timer = WaitScheduler::GetSingleton().ScheduleRealTime(std::chrono::duration<float>(remaining).count(),
+                [this, key, serial]() { FlushWindow(key, serial); });
+            return;
+        }
+        closed = std::move(it->second);
+        windows.erase(it);
+    }
+    Send(closed.eventName, closed.filterId, closed.last, RE::TESForm::LookupByID<RE::TESObjectREFR>(closed.last.subject), closed.events);
+}
+
+void GameEventFilter::Send(const std::string& eventName, FilterId id, const Observed& view, RE::TESObjectREFR* subjectRef, std::uint32_t events) {
+    forwarded[Slot(view.kind)].fetch_add(1, std::memory_order_relaxed);
+    auto details = std::format("{}|{}|{}|{}|{}", view.other, view.form, view.state, view.count, events);
+    SKSE::ModCallbackEvent modEvent{ RE::BSFixedString(eventName.c_str()), RE::BSFixedString(details.c_str()), static_cast<float>(id), subjectRef };
+    SKSE::GetModCallbackEventSource()->SendEvent(&modEvent);
+}
+
+RE::BSEventNotifyControl GameEventFilter::ProcessEvent(const RE::TESHitEvent* a_event, RE::BSTEventSource<RE::TESHitEvent>*) {
+    if (!a_event || !IsActive(kHit)) {
+        return RE::BSEventNotifyControl::kContinue;
+    }
+    auto* target = a_event->target.get();
+    Observed observed{ kHit, target, FormIDOf(target), FormIDOf(a_event->cause.get()), a_event->source,
+                       static_cast<std::int32_t>(a_event->flags.underlying()), 0 };
+    Dispatch({ &observed, 1 });
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl GameEventFilter::ProcessEvent(const RE::TESCombatEvent* a_event, RE::BSTEventSource<RE::TESCombatEvent>*) {
+    if (!a_event || !IsActive(kCombat)) {
+        return RE::BSEventNotifyControl::kContinue;
+    }
+    auto* actor = a_event->actor.get();
+    Observed observed{ kCombat, actor, FormIDOf(actor), FormIDOf(a_event->targetActor.get()), 0,
+                       static_cast<std::int32_t>(a_event->newState.underlying()), 0 };
+    Dispatch({ &observed, 1 });
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl GameEventFilter::ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>*) {
+    if (!a_event || !IsActive(kEquip)) {
+        return RE::BSEventNotifyControl::kContinue;
+    }
+    auto* actor = a_event->actor.get();
+    Observed observed{ kEquip, actor, FormIDOf(actor), 0, a_event->baseObject, a_event->equipped ? 1 : 0, 0 };
+    Dispatch({ &observed, 1 });
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl GameEventFilter::ProcessEvent(const RE::TESContainerChangedEvent* a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>*) {
+    if (!a_event || !IsActive(kContainer)) {
+        return RE::BSEventNotifyControl::kContinue;
+    }
+    std::array<Observed, 2> views;
+    std::size_t count = 0;
+    if (a_event->newContainer) {
+        views[count++] = Observed{ kContainer, RE::TESForm::LookupByID<RE::TESObjectREFR>(a_event->newContainer), a_event->newContainer,
+                                   a_event->oldContainer, a_event->baseObj, 1, a_event->itemCount };
+    }
+    if (a_event->oldContainer) {
+        views[count++] = Observed{ kContainer, RE::TESForm::LookupByID<RE::TESObjectREFR>(a_event->oldContainer), a_event->oldContainer,
+                                   a_event->newContainer, a_event->baseObj, 0, a_event->itemCount };
+    }
+    Dispatch({ views.data(), count });
+    return RE::BSEventNotifyControl::kContinue;
+}
+#pragma endregion
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "scheduler.h"
+
+namespace SLT {
+
+#pragma region GameEventFilter
+constexpr FilterId INVALID_FILTER = 0;
+
+// Native sinks for the high-frequency game events triggers listen to (hits, combat state, equip,
+// container changes). Each event is tested against the registered filters and only a match is
+// forwarded, as a mod event named by the filter with sender = the subject reference,
+// numArg = filter id and strArg = "<other form id>|<form id>|<state>|<item count>|<events>"
+// (decimal; the item count is 0 except for container changes). With no filter of a kind
+// registered, events of that kind are dropped after one atomic load.
+//
+// A filter with a delivery window coalesces bursts: matches for the same subject within the
+// window become one mod event carrying the last event's fields and the number of events it
+// stands for. A fixed window closes windowSeconds after its first event; a debounced one closes
+// once the subject has been quiet for windowSeconds.
+class GameEventFilter : public RE::BSTEventSink<RE::TESHitEvent>,
+                        public RE::BSTEventSink<RE::TESCombatEvent>,
+                        public RE::BSTEventSink<RE::TESEquipEvent>,
+                        public RE::BSTEventSink<RE::TESContainerChangedEvent> {
+public:
+    enum Kind : std::int32_t {
+        kHit = 1,
+        kCombat = 2,
+        kEquip = 3,
+        kContainer = 4
+    };
+    static constexpr std::size_t kKindCount = 4;
+
+    // Per kind:
+    //   subject  hit target | combat actor | equipping actor | either container
+    //   other    aggressor  | combat target | unused         | the other container
+    //   form     weapon/spell source | unused | base object  | base object
+    //   state    required hit flags (power 1, sneak 2, bash 4, blocked 8) | combat state |
+    //            1 equip, 0 unequip | 1 added to subject, 0 removed from subject
+    // A zero form id, null keyword or negative state matches anything.
+    struct Criteria {
+        Kind kind;
+        RE::FormID subject = 0;
+        RE::FormID other = 0;
+        RE::FormID form = 0;
+        RE::BGSKeyword* subjectKeyword = nullptr;
+        std::int32_t state = -1;
+    };
+
+    struct Delivery {
+        float windowSeconds = 0.0f; // 0 forwards every match immediately
+        bool debounce = false;
+    };
+
+    struct Stats {
+        std::array<std::uint64_t, kKindCount> seen;
+        std::array<std::uint64_t, kKindCount> forwarded;
+        std::array<std::uint64_t, kKindCount> merged; // matches folded into an open window
+    };
+
+    static GameEventFilter& GetSingleton() {
+        static GameEventFilter singleton;
+        return singleton;
+    }
+
+    // Registers with the script event source holder; call once data is loaded
+    void Install();
+
+    // Returns INVALID_FILTER for an unknown kind or an empty event name
+    FilterId Register(std::string_view eventName, const Criteria& criteria, const Delivery& delivery);
+    void Unregister(FilterId id);
+    void Clear();
+
+    // Applies to windows opened from now on; returns false for an unknown filter
+    bool SetDelivery(FilterId id, const Delivery& delivery);
+
+    Stats GetStats() const;
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESHitEvent* a_event, RE::BSTEventSource<RE::TESHitEvent>*) override;
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESCombatEvent* a_event, RE::BSTEventSource<RE::TESCombatEvent>*) override;
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>*) override;
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESContainerChangedEvent* a_event, RE::BSTEventSource<RE::TESContainerChangedEvent>*) override;
+
+private:
+    struct Filter {
+        FilterId id;
+        std::string eventName;
+        Criteria criteria;
+        Delivery delivery;
+    };
+
+    // what one incoming event looks like once reduced to the fields filters test
+    struct Observed {
+        Kind kind;
+        RE::TESObjectREFR* subjectRef;
+        RE::FormID subject;
+        RE::FormID other;
+        RE::FormID form;
+        std::int32_t state;
+        std::int32_t count;
+    };
+
+    using SteadyClock = std::chrono::steady_clock;
+
+    // one open coalescing window per (filter, subject)
+    struct Window {
+        std::uint64_t serial;
+        std::string eventName;
+        FilterId filterId;
+        Observed last;
+        std::uint32_t events;
+        SteadyClock::time_point deadline;
+        TimerId timer;
+    };
+
+    mutable std::mutex mutex;
+    std::array<std::vector<Filter>, kKindCount> filters;
+    std::array<std::atomic<std::uint32_t>, kKindCount> active{};
+    std::array<std::atomic<std::uint64_t>, kKindCount> seen{};
+    std::array<std::atomic<std::uint64_t>, kKindCount> forwarded{};
+    std::array<std::atomic<std::uint64_t>, kKindCount> merged{};
+    std::unordered_map<std::uint64_t, Window> windows;
+    FilterId nextId = 1;
+    std::uint64_t nextSerial = 1;
+
+    static std::size_t Slot(Kind kind) { return static_cast<std::size_t>(kind) - 1; }
+
+    bool IsActive(Kind kind);
+    static bool Matches(const Criteria& criteria, const Observed& observed);
+    // a container change is seen from both containers; each filter is forwarded at most once
+    void Dispatch(std::span<const Observed> views);
+    void CoalesceLocked(const Filter& filter, const Observed& observed);
+    void FlushWindow(std::uint64_t key, std::uint64_t serial);
+    void DropWindowsLocked(FilterId filterId);
+    void Send(const std::string& eventName, FilterId id, const Observed& view, RE::TESObjectREFR* subjectRef, std::uint32_t events);
+
+    GameEventFilter() = default;
+    GameEventFilter(const GameEventFilter&) = delete;
+    GameEventFilter& operator=(const GameEventFilter&) = delete;
+};
+#pragma endregion
+}
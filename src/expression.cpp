@@ -0,0 +1,581 @@
+#include "expression.h"
+#include "sl_triggers.h"
+#include "variables.h"
+
+namespace SLT {
+
+#pragma region Expression values
+ExprValue ExprValueFromString(std::string_view str) {
+    if (str.empty()) {
+        return std::string{};
+    }
+
+    const char* begin = str.data();
+    const char* end = begin + str.size();
+
+    std::int32_t intValue;
+    std::from_chars_result intResult;
+    if (str.size() > 2 && (str.substr(0, 2) == "0x" || str.substr(0, 2) == "0X")) {
+        intResult = std::from_chars(begin + 2, end, intValue, 16);
+    } else {
+        intResult = std::from_chars(begin, end, intValue, 10);
+    }
+    if (intResult.ec == std::errc{} && intResult.ptr == end) {
+        return intValue;
+    }
+
+    float floatValue;
+    auto floatResult = std::from_chars(begin, end, floatValue);
+    if (floatResult.ec == std::errc{} && floatResult.ptr == end) {
+        return floatValue;
+    }
+
+    return std::string(str);
+}
+
+ExprValue ExprValueFromText(std::string_view str) {
+    auto value = ExprValueFromString(str);
+    if (std::holds_alternative<std::string>(value)) {
+        return value;
+    }
+    // 0x10, 05 or 1.5 would print back differently, so they stay as written
+    if (ExprValueToString(value) != str) {
+        return std::string(str);
+    }
+    return value;
+}
+
+std::string ExprValueToString(const ExprValue& value) {
+    return std::visit([](const auto& v) -> std::string {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+            return "";
+        } else if constexpr (std::is_same_v<T, bool>) {
+            // as Papyrus casts a Bool to a String
+            return v ? "True" : "False";
+        } else if constexpr (std::is_same_v<T, std::int32_t>) {
+            return std::to_string(v);
+        } else if constexpr (std::is_same_v<T, float>) {
+            // as Papyrus converts floats to strings (%f), so results read back with the same type
+            return std::format("{:.6f}", v);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return v;
+        } else {
+            return v ? Util::String::ToHex(v->GetFormID()) : "";
+        }
+    }, value);
+}
+#pragma endregion
+
+#pragma region CompiledExpression
+namespace {
+constexpr int UNARY_PRECEDENCE = 7;
+
+struct OperatorInfo {
+    ExprOp op;
+    int precedence;
+};
+
+std::optional<OperatorInfo> LookupBinaryOperator(std::string_view token) {
+    static const std::unordered_map<std::string_view, OperatorInfo> binaryOperators = {
+        { "||",  { ExprOp::Or, 1 } },
+        { "&&",  { ExprOp::And, 2 } },
+        { "=",   { ExprOp::Equal, 3 } },
+        { "==",  { ExprOp::Equal, 3 } },
+        { "!=",  { ExprOp::NotEqual, 3 } },
+        { "<",   { ExprOp::Less, 3 } },
+        { "<=",  { ExprOp::LessEqual, 3 } },
+        { ">",   { ExprOp::Greater, 3 } },
+        { ">=",  { ExprOp::GreaterEqual, 3 } },
+        { "&=",  { ExprOp::StringEqual, 3 } },
+        { "&!=", { ExprOp::StringNotEqual, 3 } },
+        { "&",   { ExprOp::Concat, 4 } },
+        { "+",   { ExprOp::Add, 5 } },
+        { "-",   { ExprOp::Subtract, 5 } },
+        { "*",   { ExprOp::Multiply, 6 } },
+        { "/",   { ExprOp::Divide, 6 } },
+        { "%",   { ExprOp::Modulo, 6 } },
+    };
+
+    auto it = binaryOperators.find(token);
+    if (it == binaryOperators.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool IsUnaryOp(ExprOp op) {
+    return op == ExprOp::Negate || op == ExprOp::Not;
+}
+
+// Strips the surrounding quotes (and an optional leading '$') and collapses "" escapes
+std::string UnquoteLiteral(std::string_view token, std::size_t prefixLength) {
+    std::string_view inner = token.substr(prefixLength);
+    if (!inner.empty() && inner.back() == '"') {
+        inner.remove_suffix(1);
+    }
+
+    std::string result;
+    result.reserve(inner.size());
+    for (std::size_t i = 0; i < inner.size(); ++i) {
+        result += inner[i];
+        if (inner[i] == '"' && i + 1 < inner.size() && inner[i + 1] == '"') {
+            ++i;
+        }
+    }
+    return result;
+}
+
+struct Number {
+    bool isInt;
+    std::int32_t i;
+    float f;
+
+    float AsFloat() const { return isInt ? static_cast<float>(i) : f; }
+};
+
+Number ToNumber(const ExprValue& value) {
+    return std::visit([](const auto& v) -> Number {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, bool>) {
+            return { true, v ? 1 : 0, 0.0f };
+        } else if constexpr (std::is_same_v<T, std::int32_t>) {
+            return { true, v, 0.0f };
+        } else if constexpr (std::is_same_v<T, float>) {
+            return { false, 0, v };
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            auto parsed = ExprValueFromString(Util::String::trim(v));
+            if (auto* i = std::get_if<std::int32_t>(&parsed)) {
+                return { true, *i, 0.0f };
+            }
+            if (auto* f = std::get_if<float>(&parsed)) {
+                return { false, 0, *f };
+            }
+            return { true, 0, 0.0f };
+        } else {
+            return { true, 0, 0.0f };
+        }
+    }, value);
+}
+
+ExprValue Arithmetic(ExprOp op, const ExprValue& lhs, const ExprValue& rhs) {
+    Number a = ToNumber(lhs);
+    Number b = ToNumber(rhs);
+
+    if (a.isInt && b.isInt) {
+        // Papyrus ints wrap rather than trap
+        std::int64_t wide = 0;
+        switch (op) {
+            case ExprOp::Add:       wide = static_cast<std::int64_t>(a.i) + b.i; break;
+            case ExprOp::Subtract:  wide = static_cast<std::int64_t>(a.i) - b.i; break;
+            case ExprOp::Multiply:  wide = static_cast<std::int64_t>(a.i) * b.i; break;
+            case ExprOp::Divide:
+            case ExprOp::Modulo:
+                if (b.i == 0) {
+                    logger::warn("Expression: integer division by zero, result is 0");
+                    return std::int32_t{ 0 };
+                }
+                wide = op == ExprOp::Divide ? static_cast<std::int64_t>(a.i) / b.i : static_cast<std::int64_t>(a.i) % b.i;
+                break;
+            default: break;
+        }
+        return static_cast<std::int32_t>(static_cast<std::uint32_t>(wide));
+    }
+
+    float x = a.AsFloat();
+    float y = b.AsFloat();
+    switch (op) {
+        case ExprOp::Add:       return x + y;
+        case ExprOp::Subtract:  return x - y;
+        case ExprOp::Multiply:  return x * y;
+        case ExprOp::Divide:
+        case ExprOp::Modulo:
+            if (y == 0.0f) {
+                logger::warn("Expression: float division by zero, result is 0");
+                return 0.0f;
+            }
+            return op == ExprOp::Divide ? x / y : std::fmod(x, y);
+        default:
+            return 0.0f;
+    }
+}
+
+// '==' and the ordering operators see both sides as the text the script would hold for them
+bool Equal(const ExprValue& lhs, const ExprValue& rhs) {
+    return SmartComparator::Equals(ExprValueToString(lhs), ExprValueToString(rhs));
+}
+
+bool Ordered(ExprOp op, const ExprValue& lhs, const ExprValue& rhs) {
+    auto order = SmartComparator::Compare(ExprValueToString(lhs), ExprValueToString(rhs));
+    switch (op) {
+        case ExprOp::Less:          return order < 0;
+        case ExprOp::LessEqual:     return order <= 0;
+        case ExprOp::Greater:       return order > 0;
+        case ExprOp::GreaterEqual:  return order >= 0;
+        default:                    return false;
+    }
+}
+}
+
+std::shared_ptr<CompiledExpression> CompiledExpression::Compile(const std::vector<std::string>& tokens, std::string& error) {
+    auto expr = std::make_shared<CompiledExpression>();
+
+    auto pushConst = [&expr](ExprValue value) {
+        expr->program.push_back({ ExprOp::PushConst, static_cast<std::uint32_t>(expr->constants.size()) });
+        expr->constants.push_back(std::move(value));
+    };
+
+    auto pushVar = [&expr](std::string_view name) {
+        auto it = std::find_if(expr->variables.begin(), expr->variables.end(),
+            [name](const std::string& existing) { return Util::String::iEquals(existing, name); });
+        std::size_t index = std::distance(expr->variables.begin(), it);
+        if (it == expr->variables.end()) {
+            expr->variables.emplace_back(name);
+        }
+        expr->program.push_back({ ExprOp::PushVar, static_cast<std::uint32_t>(index) });
+    };
+
+    auto emitOperand = [&](const std::string& token) {
+        if (token.size() >= 2 && token[0] == '$' && token[1] == '"') {
+            // $"...{var}..." becomes a chain of concatenations
+            auto pieces = SLTNativeFunctions::TokenizeForVariableSubstitution(UnquoteLiteral(token, 2));
+            if (pieces.empty()) {
+                pushConst(std::string{});
+                return;
+            }
+            for (std::size_t i = 0; i < pieces.size(); ++i) {
+                if (pieces[i].isVariable) {
+                    pushVar(pieces[i].text);
+                } else {
+                    pushConst(pieces[i].text);
+                }
+                if (i > 0) {
+                    expr->program.push_back({ ExprOp::Concat });
+                }
+            }
+        } else if (token[0] == '"') {
+            pushConst(UnquoteLiteral(token, 1));
+        } else if (token.size() > 1 && token[0] == '$') {
+            pushVar(std::string_view(token).substr(1));
+        } else {
+            pushConst(ExprValueFromText(token));
+        }
+    };
+
+    struct PendingOp {
+        ExprOp op;
+        int precedence;
+        bool isParen;
+    };
+    std::vector<PendingOp> opStack;
+    bool expectOperand = true;
+
+    for (const auto& token : tokens) {
+        if (token.empty()) {
+            continue;
+        }
+
+        if (expectOperand) {
+            if (token == "(") {
+                opStack.push_back({ ExprOp::PushConst, 0, true });
+            } else if (token == "-") {
+                opStack.push_back({ ExprOp::Negate, UNARY_PRECEDENCE, false });
+            } else if (token == "!") {
+                opStack.push_back({ ExprOp::Not, UNARY_PRECEDENCE, false });
+            } else if (token == ")" || LookupBinaryOperator(token)) {
+                error = std::format("expected an operand but found '{}'", token);
+                return nullptr;
+            } else {
+                emitOperand(token);
+                expectOperand = false;
+            }
+            continue;
+        }
+
+        if (token == ")") {
+            while (!opStack.empty() && !opStack.back().isParen) {
+                expr->program.push_back({ opStack.back().op });
+                opStack.pop_back();
+            }
+            if (opStack.empty()) {
+                error = "unbalanced ')'";
+                return nullptr;
+            }
+            opStack.pop_back();
+            continue;
+        }
+
+        auto binop = LookupBinaryOperator(token);
+        if (!binop) {
+            error = std::format("expected an operator but found '{}'", token);
+            return nullptr;
+        }
+
+        while (!opStack.empty() && !opStack.back().isParen && opStack.back().precedence >= binop->precedence) {
+            expr->program.push_back({ opStack.back().op });
+            opStack.pop_back();
+        }
+        opStack.push_back({ binop->op, binop->precedence, false });
+        expectOperand = true;
+    }
+
+    if (expectOperand) {
+        error = expr->program.empty() && opStack.empty() ? "empty expression" : "expression ends with an operator";
+        return nullptr;
+    }
+
+    while (!opStack.empty()) {
+        if (opStack.back().isParen) {
+            error = "unbalanced '('";
+            return nullptr;
+        }
+        expr->program.push_back({ opStack.back().op });
+        opStack.pop_back();
+    }
+
+    std::size_t depth = 0;
+    for (const auto& instr : expr->program) {
+        if (instr.op == ExprOp::PushConst || instr.op == ExprOp::PushVar) {
+            expr->maxStackDepth = std::max(expr->maxStackDepth, ++depth);
+        } else if (!IsUnaryOp(instr.op)) {
+            --depth;
+        }
+    }
+
+    return expr;
+}
+
+ExprValue CompiledExpression::Evaluate(std::span<const ExprValue> variableValues) const {
+    std::vector<ExprValue> stack;
+    stack.reserve(maxStackDepth);
+
+    for (const auto& instr : program) {
+        switch (instr.op) {
+            case ExprOp::PushConst:
+                stack.push_back(constants[instr.operand]);
+                continue;
+            case ExprOp::PushVar:
+                stack.push_back(instr.operand < variableValues.size() ? variableValues[instr.operand] : ExprValue{});
+                continue;
+            case ExprOp::Negate: {
+                Number n = ToNumber(stack.back());
+                // wraps like the binary ops: -INT_MIN is INT_MIN
+                stack.back() = n.isInt ? ExprValue{ static_cast<std::int32_t>(0u - static_cast<std::uint32_t>(n.i)) } : ExprValue{ -n.f };
+                continue;
+            }
+            case ExprOp::Not:
+                stack.back() = !SmartComparator::Truthy(stack.back());
+                continue;
+            default:
+                break;
+        }
+
+        ExprValue rhs = std::move(stack.back());
+        stack.pop_back();
+        ExprValue& lhs = stack.back();
+
+        switch (instr.op) {
+            case ExprOp::Add:
+            case ExprOp::Subtract:
+            case ExprOp::Multiply:
+            case ExprOp::Divide:
+            case ExprOp::Modulo:
+                lhs = Arithmetic(instr.op, lhs, rhs);
+                break;
+            case ExprOp::Concat:
+                lhs = ExprValueToString(lhs) + ExprValueToString(rhs);
+                break;
+            case ExprOp::Equal:
+                lhs = Equal(lhs, rhs);
+                break;
+            case ExprOp::NotEqual:
+                lhs = !Equal(lhs, rhs);
+                break;
+            case ExprOp::Less:
+            case ExprOp::LessEqual:
+            case ExprOp::Greater:
+            case ExprOp::GreaterEqual:
+                lhs = Ordered(instr.op, lhs, rhs);
+                break;
+            case ExprOp::StringEqual:
+                lhs = ExprValueToString(lhs) == ExprValueToString(rhs);
+                break;
+            case ExprOp::StringNotEqual:
+                lhs = ExprValueToString(lhs) != ExprValueToString(rhs);
+                break;
+            case ExprOp::And:
+                lhs = SmartComparator::Truthy(lhs) && SmartComparator::Truthy(rhs);
+                break;
+            case ExprOp::Or:
+                lhs = SmartComparator::Truthy(lhs) || SmartComparator::Truthy(rhs);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return stack.empty() ? ExprValue{} : std::move(stack.back());
+}
+
+ExprValue CompiledExpression::Evaluate(const VariableResolver& resolver) const {
+    std::vector<ExprValue> values;
+    values.reserve(variables.size());
+    for (const auto& name : variables) {
+        values.push_back(resolver ? resolver(name) : ExprValue{});
+    }
+    return Evaluate(values);
+}
+#pragma endregion
+
+#pragma region ExpressionCache
+std::shared_ptr<const CompiledExpression> ExpressionCache::GetOrCompile(std::string_view scriptName, std::int32_t lineNo,
+                                                                        std::span<const std::string> tokens,
+                                                                        std::int32_t tokenIndex) {
+    std::string key(scriptName);
+    const auto entryKey = EntryKey(lineNo, tokenIndex);
+    {
+        std::shared_lock lock(mutex);
+        auto scriptIt = scripts.find(key);
+        if (scriptIt != scripts.end()) {
+            auto lineIt = scriptIt->second.lines.find(entryKey);
+            if (lineIt != scriptIt->second.lines.end() && std::ranges::equal(lineIt->second.tokens, tokens)) {
+                scriptIt->second.lastUse.store(useClock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return lineIt->second.compiled;
+            }
+        }
+    }
+
+    std::vector<std::string> owned(tokens.begin(), tokens.end());
+    std::string error;
+    std::shared_ptr<const CompiledExpression> compiled = CompiledExpression::Compile(owned, error);
+    if (!compiled) {
+        logger::error("{}({}): unable to compile expression '{}': {}", scriptName, lineNo, Util::String::Join(owned, " "), error);
+    }
+
+    std::unique_lock lock(mutex);
+    auto& entries = scripts[key];
+    if (entries.lines.insert_or_assign(entryKey, Entry{ std::move(owned), compiled, {}, {} }).second) {
+        entryCount++;
+    }
+    entries.lastUse.store(useClock.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (entryCount > kMaxEntries) {
+        EvictLocked(key);
+    }
+    return compiled;
+}
+
+BoundExpression ExpressionCache::GetOrCompileBound(const std::shared_ptr<const LoadedScript>& script, std::int32_t lineNo,
+                                                   std::span<const std::string> tokens, std::int32_t tokenIndex) {
+    BoundExpression bound;
+    if (!script) {
+        return bound;
+    }
+
+    const auto entryKey = EntryKey(lineNo, tokenIndex);
+    {
+        std::shared_lock lock(mutex);
+        auto scriptIt = scripts.find(script->name);
+        if (scriptIt != scripts.end()) {
+            auto lineIt = scriptIt->second.lines.find(entryKey);
+            if (lineIt != scriptIt->second.lines.end() && std::ranges::equal(lineIt->second.tokens, tokens) &&
+                lineIt->second.boundScript.lock() == script) {
+                scriptIt->second.lastUse.store(useClock.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                bound.compiled = lineIt->second.compiled;
+                bound.variableSlots = lineIt->second.variableSlots;
+                return bound;
+            }
+        }
+    }
+
+    bound.compiled = GetOrCompile(script->name, lineNo, tokens, tokenIndex);
+    if (!bound.compiled) {
+        return bound;
+    }
+
+    bound.variableSlots.reserve(bound.compiled->GetVariableNames().size());
+    for (const auto& name : bound.compiled->GetVariableNames()) {
+        bound.variableSlots.push_back(script->FindSlot(name));
+    }
+
+    std::unique_lock lock(mutex);
+    auto scriptIt = scripts.find(script->name);
+    if (scriptIt != scripts.end()) {
+        auto lineIt = scriptIt->second.lines.find(entryKey);
+        if (lineIt != scriptIt->second.lines.end() && lineIt->second.compiled == bound.compiled) {
+            lineIt->second.boundScript = script;
+            lineIt->second.variableSlots = bound.variableSlots;
+        }
+    }
+    return bound;
+}
+
+ExprValue BoundExpression::EvaluateInFrame(FrameHandle frameHandle) const {
+    if (!compiled) {
+        return {};
+    }
+
+    auto& store = VariableStore::GetSingleton();
+    const auto& names = compiled->GetVariableNames();
+    std::vector<ExprValue> values;
+    values.reserve(names.size());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        std::optional<std::string> raw;
+        if (variableSlots[i] != NO_SLOT) {
+            raw = store.GetFrameSlot(frameHandle, variableSlots[i]);
+        } else {
+            raw = store.GetFrameVar(frameHandle, names[i]);
+            if (!raw) {
+                raw = store.GetGlobalVar(names[i]);
+            }
+        }
+        values.push_back(raw ? ExprValueFromText(*raw) : ExprValue{});
+    }
+
+    return compiled->Evaluate(values);
+}
+
+void ExpressionCache::Invalidate(std::string_view scriptName) {
+    std::unique_lock lock(mutex);
+    auto it = scripts.find(std::string(scriptName));
+    if (it != scripts.end()) {
+        entryCount -= it->second.lines.size();
+        scripts.erase(it);
+    }
+}
+
+void ExpressionCache::Clear() {
+    std::unique_lock lock(mutex);
+    scripts.clear();
+    entryCount = 0;
+}
+
+std::size_t ExpressionCache::Size() const {
+    std::shared_lock lock(mutex);
+    return entryCount;
+}
+
+void ExpressionCache::EvictLocked(const std::string& keep) {
+    std::vector<std::pair<std::uint64_t, std::string>> byUse;
+    byUse.reserve(scripts.size());
+    for (const auto& [name, entries] : scripts) {
+        if (!str::iEquals(name, keep)) {
+            byUse.emplace_back(entries.lastUse.load(std::memory_order_relaxed), name);
+        }
+    }
+    std::ranges::sort(byUse);
+
+    // down to three quarters, so a full cache does not evict on every compile
+    std::size_t evicted = 0;
+    for (const auto& [_, name] : byUse) {
+        if (entryCount <= kMaxEntries / 4 * 3) {
+            break;
+        }
+        auto it = scripts.find(name);
+        entryCount -= it->second.lines.size();
+        scripts.erase(it);
+        evicted++;
+    }
+    logger::debug("ExpressionCache: evicted {} scripts, {} expressions cached", evicted, entryCount);
+}
+#pragma endregion
+}
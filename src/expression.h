@@ -0,0 +1,160 @@
+#pragma once
+
+#include "engine.h"
+#include "script.h"
+
+namespace SLT {
+
+#pragma region Expression values
+using ExprValue = SmartComparator::Value;
+
+// Infers the most specific value for a raw string: int (decimal or 0x hex), then float, then string
+ExprValue ExprValueFromString(std::string_view str);
+
+// The value of text a script holds (a literal token or a variable's value): a number only where
+// ExprValueToString gives the same text back, otherwise the text itself, so comparisons and '&'
+// see exactly what was written (0x10 stays 0x10, 1.5 stays 1.5)
+ExprValue ExprValueFromText(std::string_view str);
+
+std::string ExprValueToString(const ExprValue& value);
+#pragma endregion
+
+#pragma region CompiledExpression
+enum class ExprOp : std::uint8_t {
+    PushConst,
+    PushVar,
+
+    // unary
+    Negate,
+    Not,
+
+    // binary
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Concat,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    StringEqual,
+    StringNotEqual,
+    And,
+    Or
+};
+
+struct ExprInstruction {
+    ExprOp op;
+    std::uint32_t operand = 0; // constant or variable index for PushConst/PushVar
+};
+
+// An SLT expression (a token sequence as produced by Tokenizev2) compiled once into an
+// RPN program. Results are what the Papyrus side computes, except where noted:
+//   ==, !=     SmartComparator::Equals (the SmartEquals native) on both sides' text
+//   < <= > >=  SmartComparator::Compare, floats read the same way; 0x hex and other text are 0
+//   &=, &!=    exact text comparison
+//   ! && ||    SmartComparator::Truthy: "", "0" and "false" (any case) are false, other text is true
+//   + - * / %  ints (decimal or 0x hex) stay ints and wrap, so 7 / 2 is 3 where the Papyrus side
+//              divides as floats; anything with a float operand is float arithmetic
+// Booleans print as Papyrus casts them ("True"/"False"), floats with six decimals (%f).
+class CompiledExpression {
+public:
+    using VariableResolver = std::function<ExprValue(std::string_view)>;
+
+    // Returns nullptr and fills error if the tokens are not a well-formed expression
+    static std::shared_ptr<CompiledExpression> Compile(const std::vector<std::string>& tokens, std::string& error);
+
+    // variableValues must line up with GetVariableNames()
+    ExprValue Evaluate(std::span<const ExprValue> variableValues) const;
+    ExprValue Evaluate(const VariableResolver& resolver) const;
+
+    const std::vector<std::string>& GetVariableNames() const { return variables; }
+    bool IsConstant() const { return variables.empty(); }
+
+private:
+    std::vector<ExprInstruction> program;
+    std::vector<ExprValue> constants;
+    std::vector<std::string> variables; // without the leading '$'
+    std::size_t maxStackDepth = 0;
+};
+#pragma endregion
+
+#pragma region ExpressionCache
+// A compiled expression together with the frame slot of each of its variables
+struct BoundExpression {
+    std::shared_ptr<const CompiledExpression> compiled;
+    std::vector<std::int32_t> variableSlots; // parallel to GetVariableNames(); NO_SLOT means resolve by name
+
+    // Evaluates against a variable frame bound to the same script; unslotted names fall back to globals
+    ExprValue EvaluateInFrame(FrameHandle frameHandle) const;
+};
+
+// Compiled expressions keyed by script name, script line number and token index. An entry is
+// reused only while the line's tokens are unchanged, so an edited script recompiles on first use;
+// ScriptLibrary drops a script's entries whenever it (re)loads it. Past kMaxEntries the scripts
+// used least recently are dropped whole.
+class ExpressionCache {
+public:
+    // Token index of an expression made of the rest of the line (set, if, while and the natives)
+    static constexpr std::int32_t kWholeLine = -1;
+
+    static constexpr std::size_t kMaxEntries = 16384;
+
+    static ExpressionCache& GetSingleton() {
+        static ExpressionCache singleton;
+        return singleton;
+    }
+
+    // Returns nullptr if the tokens do not compile; the failure is cached and logged once
+    std::shared_ptr<const CompiledExpression> GetOrCompile(std::string_view scriptName, std::int32_t lineNo,
+                                                           std::span<const std::string> tokens,
+                                                           std::int32_t tokenIndex = kWholeLine);
+
+    // As GetOrCompile, additionally resolving variable slots against the script's layout (cached with the entry)
+    BoundExpression GetOrCompileBound(const std::shared_ptr<const LoadedScript>& script, std::int32_t lineNo,
+                                      std::span<const std::string> tokens, std::int32_t tokenIndex = kWholeLine);
+
+    void Invalidate(std::string_view scriptName);
+    void Clear();
+
+    // Number of cached expressions across all scripts
+    std::size_t Size() const;
+
+private:
+    struct Entry {
+        std::vector<std::string> tokens;
+        std::shared_ptr<const CompiledExpression> compiled;
+        std::weak_ptr<const LoadedScript> boundScript;
+        std::vector<std::int32_t> variableSlots;
+    };
+
+    // (lineNo, tokenIndex) packed by EntryKey
+    using LineMap = std::unordered_map<std::uint64_t, Entry>;
+
+    static std::uint64_t EntryKey(std::int32_t lineNo, std::int32_t tokenIndex) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(lineNo)) << 32) | static_cast<std::uint32_t>(tokenIndex);
+    }
+
+    struct ScriptEntries {
+        LineMap lines;
+        std::atomic<std::uint64_t> lastUse = 0; // useClock when last compiled into or hit
+    };
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, ScriptEntries, CaseInsensitiveHash, CaseInsensitiveEqual> scripts;
+    std::size_t entryCount = 0;
+    std::atomic<std::uint64_t> useClock = 0; // advanced per compile
+
+    // Drops the least recently used scripts other than keep; mutex must be held exclusively
+    void EvictLocked(const std::string& keep);
+
+    ExpressionCache() = default;
+    ExpressionCache(const ExpressionCache&) = delete;
+    ExpressionCache& operator=(const ExpressionCache&) = delete;
+};
+#pragma endregion
+}
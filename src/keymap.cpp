@@ -0,0 +1,165 @@
+#include "keymap.h"
+
+namespace SLT {
+
+#pragma region KeyChordSink
+namespace {
+constexpr std::int32_t kWheelUp = static_cast<std::int32_t>(KeyUtil::KBM_OFFSETS::kMacro_MouseWheelOffset);
+constexpr std::int32_t kWheelDown = kWheelUp + 1;
+}
+
+void KeyChordSink::Install() {
+    auto* inputManager = RE::BSInputDeviceManager::GetSingleton();
+    if (!inputManager) {
+        logger::error("KeyChordSink: input device manager unavailable, key chords will not fire");
+        return;
+    }
+    inputManager->AddEventSink(this);
+}
+
+ChordId KeyChordSink::Register(std::string_view eventName, std::int32_t triggerKey, std::span<const std::int32_t> modifiers, float holdSeconds) {
+    if (eventName.empty() || triggerKey < 0 || triggerKey >= static_cast<std::int32_t>(kMaxKeys)) {
+        return INVALID_CHORD;
+    }
+
+    Chord chord{ INVALID_CHORD, std::string(eventName), triggerKey, {}, 0, std::max(holdSeconds, 0.0f) };
+    for (auto modifier : modifiers) {
+        if (modifier < 0 || modifier >= static_cast<std::int32_t>(kMaxKeys) || modifier == triggerKey) {
+            return INVALID_CHORD;
+        }
+        chord.modifiers.set(static_cast<std::size_t>(modifier));
+    }
+    chord.modifierCount = chord.modifiers.count();
+
+    std::lock_guard lock(mutex);
+    if (chords.size() >= std::numeric_limits<std::uint16_t>::max()) {
+        logger::error("KeyChordSink: too many chords registered");
+        return INVALID_CHORD;
+    }
+    chord.id = nextId++;
+    chords.push_back(std::move(chord));
+    RebuildIndexLocked();
+    return chords.back().id;
+}
+
+void KeyChordSink::Unregister(ChordId id) {
+    std::lock_guard lock(mutex);
+    if (std::erase_if(chords, [id](const Chord& chord) { return chord.id == id; }) > 0) {
+        RebuildIndexLocked();
+    }
+}
+
+void KeyChordSink::Clear() {
+    std::lock_guard lock(mutex);
+    chords.clear();
+    RebuildIndexLocked();
+}
+
+void KeyChordSink::RebuildIndexLocked() {
+    for (auto& indices : byTriggerKey) {
+        indices.clear();
+    }
+    for (std::size_t i = 0; i < chords.size(); ++i) {
+        byTriggerKey[chords[i].triggerKey].push_back(static_cast<std::uint16_t>(i));
+    }
+    // most specific chord first, so the first satisfied one sets the precedence for a key
+    for (auto& indices : byTriggerKey) {
+        std::ranges::stable_sort(indices, std::greater{}, [this](std::uint16_t i) { return chords[i].modifierCount; });
+    }
+}
+
+std::int32_t KeyChordSink::ToMacroCode(const RE::ButtonEvent* button) {
+    const auto idCode = button->GetIDCode();
+    switch (button->GetDevice()) {
+        case RE::INPUT_DEVICE::kKeyboard:
+            return idCode < static_cast<std::uint32_t>(KeyUtil::KBM_OFFSETS::kMacro_NumKeyboardKeys) ? static_cast<std::int32_t>(idCode) : -1;
+        case RE::INPUT_DEVICE::kMouse:
+            // buttons 0-7, then wheel up/down as 8/9
+            return idCode < 10 ? static_cast<std::int32_t>(KeyUtil::KBM_OFFSETS::kMacro_MouseButtonOffset) + static_cast<std::int32_t>(idCode) : -1;
+        case RE::INPUT_DEVICE::kGamepad: {
+            auto code = KeyUtil::Interpreter::GamepadMaskToKeycode(idCode);
+            return code < kMaxKeys ? static_cast<std::int32_t>(code) : -1;
+        }
+        default:
+            return -1;
+    }
+}
+
+void KeyChordSink::OnButtonLocked(std::int32_t code, const RE::ButtonEvent* button, std::vector<std::pair<std::string, ChordId>>& matched) {
+    const bool wheel = code == kWheelUp || code == kWheelDown;
+    const bool down = wheel || button->IsDown();
+    const bool held = !wheel && button->IsHeld();
+    const bool up = !wheel && button->IsUp();
+
+    if (down && !wheel) {
+        pressed.set(static_cast<std::size_t>(code));
+    }
+
+    auto& indices = byTriggerKey[code];
+    if (up) {
+        pressed.reset(static_cast<std::size_t>(code));
+        for (auto i : indices) {
+            chords[i].firedThisPress = false;
+        }
+        return;
+    }
+    if (!down && !held) {
+        return;
+    }
+
+    const float heldFor = wheel ? 0.0f : button->HeldDuration();
+    std::optional<std::size_t> precedence;
+    for (auto i : indices) {
+        auto& chord = chords[i];
+        if ((chord.modifiers & pressed) != chord.modifiers) {
+            continue;
+        }
+        // only the most specific satisfied chords count: Ctrl+K shadows a plain K
+        if (!precedence) {
+            precedence = chord.modifierCount;
+        } else if (chord.modifierCount < *precedence) {
+            break;
+        }
+
+        if (down) {
+            chord.firedThisPress = false;
+        }
+        if (chord.firedThisPress || heldFor < chord.holdSeconds) {
+            continue;
+        }
+        chord.firedThisPress = true;
+        matched.emplace_back(chord.eventName, chord.id);
+    }
+}
+
+RE::BSEventNotifyControl KeyChordSink::ProcessEvent(RE::InputEvent* const* a_event, RE::BSTEventSource<RE::InputEvent*>*) {
+    if (!a_event) {
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    std::vector<std::pair<std::string, ChordId>> matched;
+    {
+        std::lock_guard lock(mutex);
+        for (auto* event = *a_event; event; event = event->next) {
+            if (event->GetEventType() != RE::INPUT_EVENT_TYPE::kButton) {
+                continue;
+            }
+            auto* button = event->AsButtonEvent();
+            auto code = button ? ToMacroCode(button) : -1;
+            if (code >= 0) {
+                OnButtonLocked(code, button, matched);
+            }
+        }
+    }
+
+    if (!matched.empty()) {
+        auto* source = SKSE::GetModCallbackEventSource();
+        for (const auto& [eventName, id] : matched) {
+            SKSE::ModCallbackEvent modEvent{ RE::BSFixedString(eventName.c_str()), RE::BSFixedString(), static_cast<float>(id), nullptr };
+            source->SendEvent(&modEvent);
+        }
+    }
+    return RE::BSEventNotifyControl::kContinue;
+}
+#pragma endregion
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+namespace SLT {
+
+#pragma region KeyChordSink
+constexpr ChordId INVALID_CHORD = 0;
+
+// Tracks which of the 282 KeyUtil macro codes are down and matches registered key chords
+// (trigger key, modifier keys, optional hold time) natively. Only a matched chord reaches
+// Papyrus, as a mod event named by the registration with numArg = chord id, so plain
+// keystrokes cause no VM traffic.
+class KeyChordSink : public RE::BSTEventSink<RE::InputEvent*> {
+public:
+    static constexpr std::size_t kMaxKeys = static_cast<std::size_t>(KeyUtil::MACRO_LIMITS::kMaxMacros);
+    using KeySet = std::bitset<kMaxKeys>;
+
+    static KeyChordSink& GetSingleton() {
+        static KeyChordSink singleton;
+        return singleton;
+    }
+
+    // Registers with the input device manager; call once input is loaded
+    void Install();
+
+    // Returns INVALID_CHORD for an out-of-range key or an empty event name
+    ChordId Register(std::string_view eventName, std::int32_t triggerKey, std::span<const std::int32_t> modifiers, float holdSeconds);
+    void Unregister(ChordId id);
+    void Clear();
+
+    // Maps a button event to its KeyUtil macro code, or -1
+    static std::int32_t ToMacroCode(const RE::ButtonEvent* button);
+
+    RE::BSEventNotifyControl ProcessEvent(RE::InputEvent* const* a_event, RE::BSTEventSource<RE::InputEvent*>*) override;
+
+private:
+    struct Chord {
+        ChordId id;
+        std::string eventName;
+        std::int32_t triggerKey;
+        KeySet modifiers;
+        std::size_t modifierCount;
+        float holdSeconds;
+        bool firedThisPress = false;
+    };
+
+    std::mutex mutex;
+    std::vector<Chord> chords;
+    // chord indices per trigger key, fewest modifiers last; rebuilt whenever chords change
+    std::array<std::vector<std::uint16_t>, kMaxKeys> byTriggerKey;
+    KeySet pressed;
+    ChordId nextId = 1;
+
+    void RebuildIndexLocked();
+    void OnButtonLocked(std::int32_t code, const RE::ButtonEvent* button, std::vector<std::pair<std::string, ChordId>>& matched);
+
+    KeyChordSink() = default;
+    KeyChordSink(const KeyChordSink&) = delete;
+    KeyChordSink& operator=(const KeyChordSink&) = delete;
+};
+#pragma endregion
+}
@@ -0,0 +1,320 @@
+#include "optimizer.h"
+#include "expression.h"
+
+namespace SLT {
+
+#pragma region ScriptOptimizer
+namespace {
+// The text the Papyrus side compares for a literal operand: a quoted string without the quotes,
+// or a bare number as written. Bare words are left alone because the Papyrus side may give them
+// meaning (resultfrom, function names, ...), and quoted strings with escapes are left alone too.
+std::optional<std::string_view> LiteralText(std::string_view token) {
+    if (token.size() >= 2 && token.front() == '"' && token.back() == '"') {
+        auto inner = token.substr(1, token.size() - 2);
+        if (inner.find('"') != std::string_view::npos) {
+            return std::nullopt;
+        }
+        return inner;
+    }
+    auto value = ExprValueFromString(token);
+    if (!std::holds_alternative<std::int32_t>(value) && !std::holds_alternative<float>(value)) {
+        return std::nullopt;
+    }
+    return token;
+}
+
+// Folds "<literal> ==|=|!= <literal>", the only condition whose outcome is known to be the
+// Papyrus side's: it is SmartComparator::Equals, the rule the SmartEquals native applies.
+// Arithmetic and ordering are left alone; CompiledExpression does not compute them the way
+// the Papyrus side does (see its notes), so folding them could change what a script does.
+std::optional<bool> FoldComparison(std::span<const std::string> tokens) {
+    if (tokens.size() != 3 || !(tokens[1] == "==" || tokens[1] == "=" || tokens[1] == "!=")) {
+        return std::nullopt;
+    }
+    auto lhs = LiteralText(tokens[0]);
+    auto rhs = LiteralText(tokens[2]);
+    if (!lhs || !rhs) {
+        return std::nullopt;
+    }
+    return SmartComparator::Equals(*lhs, *rhs) != (tokens[1] == "!=");
+}
+
+std::string DescribeRange(std::int32_t firstLineNo, std::int32_t lastLineNo) {
+    return firstLineNo == lastLineNo ? std::format("line {}", firstLineNo) : std::format("lines {}-{}", firstLineNo, lastLineNo);
+}
+
+bool IsCommand(const ScriptLine& line, std::string_view cmd) {
+    return str::iEquals(line.tokens[0], cmd);
+}
+
+bool IsLabel(const ScriptLine& line) {
+    const auto& token = line.tokens[0];
+    return token.size() >= 2 && token.front() == '[' && token.back() == ']';
+}
+
+// Lines that anchor control flow; never removed even when unreachable, so the block structure
+// (and any computed goto) still resolves exactly as in the original
+bool IsStructural(const ScriptLine& line) {
+    static constexpr std::array<std::string_view, 8> kStructural = {
+        "if", "elseif", "else", "endif", "while", "endwhile", "beginsub", "endsub"
+    };
+    return IsLabel(line) || std::any_of(kStructural.begin(), kStructural.end(),
+        [&line](std::string_view cmd) { return IsCommand(line, cmd); });
+}
+
+bool IsJumpFormIf(const ScriptLine& line) {
+    return IsCommand(line, "if") && line.blockEnd == NO_JUMP;
+}
+
+// true if [first, last] contains anything another part of the script could jump into
+bool HasEntryPoints(const LoadedScript& script, std::int32_t first, std::int32_t last) {
+    for (std::int32_t i = first; i <= last; ++i) {
+        if (IsLabel(script.lines[i]) || IsCommand(script.lines[i], "beginsub")) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+std::shared_ptr<LoadedScript> ScriptOptimizer::Optimize(const LoadedScript& original) {
+    if (original.HasErrors()) {
+        return nullptr;
+    }
+
+    auto script = std::make_shared<LoadedScript>(original);
+
+    std::size_t changes = 0;
+    changes += FoldConstants(*script);
+    changes += RemoveUnreachable(*script);
+    changes += RemoveRedundantSets(*script);
+
+    if (changes == 0) {
+        return nullptr;
+    }
+
+    script->optimized = true;
+    for (const auto& note : script->optimizerNotes) {
+        logger::debug("{}", note);
+    }
+    logger::debug("ScriptOptimizer: {} {} -> {} lines", script->name, original.lines.size(), script->lines.size());
+    return script;
+}
+
+std::size_t ScriptOptimizer::Compact(LoadedScript& script, const std::vector<bool>& remove) {
+    std::size_t removed = 0;
+    std::vector<ScriptLine> kept;
+    kept.reserve(script.lines.size());
+    for (std::size_t i = 0; i < script.lines.size(); ++i) {
+        if (remove[i]) {
+            removed++;
+        } else {
+            kept.push_back(std::move(script.lines[i]));
+        }
+    }
+    script.lines = std::move(kept);
+    if (removed > 0) {
+        ScriptLibrary::BuildControlFlow(script);
+    }
+    return removed;
+}
+
+std::size_t ScriptOptimizer::FoldConstants(LoadedScript& script) {
+    auto& lines = script.lines;
+    std::vector<bool> remove(lines.size(), false);
+    std::size_t changes = 0;
+
+    auto note = [&script](const ScriptLine& line, std::string message) {
+        script.optimizerNotes.push_back(std::format("{}({}): {}", script.name, line.lineNo, message));
+    };
+
+    for (std::int32_t i = 0; i < static_cast<std::int32_t>(lines.size()); ++i) {
+        if (remove[i]) {
+            continue;
+        }
+        auto& line = lines[i];
+        std::span<const std::string> tokens(line.tokens);
+
+        if (IsJumpFormIf(line)) {
+            auto value = FoldComparison(tokens.subspan(1, tokens.size() - 2));
+            if (!value) {
+                continue;
+            }
+            if (*value) {
+                note(line, std::format("condition is always true, jumping unconditionally to {}", line.tokens.back()));
+                line.tokens = { "goto", line.tokens.back() };
+                line.slots = { NO_SLOT, NO_SLOT };
+            } else {
+                note(line, "condition is always false, jump removed");
+                remove[i] = true;
+            }
+            changes++;
+        } else if (IsCommand(line, "if") && line.jumpTarget == line.blockEnd) {
+            // a lone if..endif; chains with elseif/else are left for the runtime
+            auto value = FoldComparison(tokens.subspan(1));
+            if (!value) {
+                continue;
+            }
+            std::int32_t endif = line.blockEnd;
+            if (*value) {
+                note(line, "condition is always true, if/endif removed");
+                remove[i] = true;
+                remove[endif] = true;
+            } else if (!HasEntryPoints(script, i + 1, endif - 1)) {
+                note(line, std::format("condition is always false, {} removed", DescribeRange(line.lineNo, lines[endif].lineNo)));
+                std::fill(remove.begin() + i, remove.begin() + endif + 1, true);
+            } else {
+                continue;
+            }
+            changes++;
+        } else if (IsCommand(line, "while")) {
+            auto value = FoldComparison(tokens.subspan(1));
+            if (!value || *value) {
+                continue;
+            }
+            std::int32_t endwhile = line.jumpTarget;
+            if (HasEntryPoints(script, i + 1, endwhile - 1)) {
+                continue;
+            }
+            note(line, std::format("condition is always false, {} removed", DescribeRange(line.lineNo, lines[endwhile].lineNo)));
+            std::fill(remove.begin() + i, remove.begin() + endwhile + 1, true);
+            changes++;
+        }
+    }
+
+    Compact(script, remove);
+    return changes;
+}
+
+std::size_t ScriptOptimizer::RemoveUnreachable(LoadedScript& script) {
+    const auto& lines = script.lines;
+    const auto count = static_cast<std::int32_t>(lines.size());
+    if (count == 0) {
+        return 0;
+    }
+
+    std::vector<bool> reached(lines.size(), false);
+    std::vector<std::int32_t> pending;
+    auto visit = [&](std::int32_t index) {
+        if (index >= 0 && index < count && !reached[index]) {
+            reached[index] = true;
+            pending.push_back(index);
+        }
+    };
+
+    visit(0);
+
+    // a computed goto/gosub may land on any label or subroutine
+    for (const auto& line : lines) {
+        if ((IsCommand(line, "goto") || IsCommand(line, "gosub")) && line.tokens.size() > 1
+                && line.tokens[1].find('$') != std::string::npos) {
+            for (const auto& [_, index] : script.labels) {
+                visit(index);
+            }
+            for (const auto& [_, index] : script.subroutines) {
+                visit(index);
+            }
+            break;
+        }
+    }
+
+    while (!pending.empty()) {
+        std::int32_t i = pending.back();
+        pending.pop_back();
+        const auto& line = lines[i];
+        const std::int32_t jt = line.jumpTarget;
+
+        if (IsCommand(line, "goto")) {
+            visit(jt);
+        } else if (IsCommand(line, "gosub")) {
+            visit(i + 1);
+            visit(jt);
+        } else if (IsCommand(line, "return") || IsCommand(line, "endsub")) {
+            // control returns to the caller
+        } else if (IsCommand(line, "if") || IsCommand(line, "elseif")) {
+            visit(i + 1);
+            visit(jt);
+        } else if (IsCommand(line, "else")) {
+            visit(i + 1);
+            visit(line.blockEnd);
+        } else if (IsCommand(line, "while")) {
+            visit(i + 1);
+            visit(jt + 1);
+        } else if (IsCommand(line, "endwhile") || IsCommand(line, "continue")) {
+            visit(jt);
+        } else if (IsCommand(line, "break")) {
+            visit(jt + 1);
+        } else if (IsCommand(line, "beginsub")) {
+            visit(i + 1);
+            visit(jt + 1);
+        } else {
+            visit(i + 1);
+        }
+    }
+
+    std::vector<bool> remove(lines.size(), false);
+    std::int32_t first = NO_JUMP;
+    auto flush = [&](std::int32_t end) {
+        if (first != NO_JUMP) {
+            script.optimizerNotes.push_back(std::format("{}({}): unreachable, {} removed",
+                script.name, lines[first].lineNo, DescribeRange(lines[first].lineNo, lines[end].lineNo)));
+            first = NO_JUMP;
+        }
+    };
+    for (std::int32_t i = 0; i < count; ++i) {
+        if (!reached[i] && !IsStructural(lines[i])) {
+            remove[i] = true;
+            if (first == NO_JUMP) {
+                first = i;
+            }
+        } else {
+            flush(i - 1);
+        }
+    }
+    flush(count - 1);
+
+    return Compact(script, remove);
+}
+
+std::size_t ScriptOptimizer::RemoveRedundantSets(LoadedScript& script) {
+    auto& lines = script.lines;
+    std::vector<bool> remove(lines.size(), false);
+
+    for (std::size_t i = 0; i + 1 < lines.size(); ++i) {
+        const auto& line = lines[i];
+        const auto& next = lines[i + 1];
+        if (!IsCommand(line, "set") || !IsCommand(next, "set") || line.tokens.size() < 3 || next.tokens.size() < 3) {
+            continue;
+        }
+        std::int32_t slot = line.slots[1];
+        if (slot == NO_SLOT || next.slots[1] != slot) {
+            continue;
+        }
+
+        // the overwritten value must come from a pure expression...
+        std::string error;
+        if (!CompiledExpression::Compile(std::vector<std::string>(line.tokens.begin() + 2, line.tokens.end()), error)) {
+            continue;
+        }
+
+        // ...and must not be read while computing its replacement
+        bool readsSlot = false;
+        for (std::size_t t = 2; t < next.tokens.size(); ++t) {
+            if (next.slots[t] == slot || next.tokens[t].starts_with("$\"")) {
+                readsSlot = true;
+                break;
+            }
+        }
+        if (readsSlot) {
+            continue;
+        }
+
+        script.optimizerNotes.push_back(std::format("{}({}): value of {} is overwritten on line {}, set removed",
+            script.name, line.lineNo, line.tokens[1], next.lineNo));
+        remove[i] = true;
+    }
+
+    return Compact(script, remove);
+}
+#pragma endregion
+}
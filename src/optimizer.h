@@ -0,0 +1,29 @@
+#pragma once
+
+#include "script.h"
+
+namespace SLT {
+
+#pragma region ScriptOptimizer
+// Rewrites a loaded script into an equivalent, shorter program:
+//   - if/while comparing two literals with ==, = or != are resolved, by the SmartEquals rule
+//     (SmartComparator::Equals), dropping the branch that can never run
+//   - lines that no control path reaches (e.g. after an unconditional goto) are removed
+//   - a set immediately overwritten by a set of the same variable is removed
+// Surviving lines keep their source line numbers and the slot layout is unchanged, so frames,
+// expression cache keys and diagnostics stay valid against the original file.
+class ScriptOptimizer {
+public:
+    // Returns nullptr when nothing could be optimized, or when the script has control flow errors
+    static std::shared_ptr<LoadedScript> Optimize(const LoadedScript& original);
+
+private:
+    static std::size_t FoldConstants(LoadedScript& script);
+    static std::size_t RemoveUnreachable(LoadedScript& script);
+    static std::size_t RemoveRedundantSets(LoadedScript& script);
+
+    // Drops every line flagged in remove and recomputes control flow; returns the number removed
+    static std::size_t Compact(LoadedScript& script, const std::vector<bool>& remove);
+};
+#pragma endregion
+}
@@ -0,0 +1,160 @@
+#include "papyrusvm.h"
+#include "expression.h"
+
+namespace SLT {
+
+#pragma region PapyrusVM
+namespace {
+std::string VariableToString(const RE::BSScript::Variable& value) {
+    if (value.IsString()) {
+        return std::string(value.GetString());
+    } else if (value.IsInt()) {
+        return std::to_string(value.GetSInt());
+    } else if (value.IsFloat()) {
+        return ExprValueToString(value.GetFloat());
+    } else if (value.IsBool()) {
+        return ExprValueToString(value.GetBool());
+    }
+    return {};
+}
+
+class GamePapyrusVM : public PapyrusVM {
+public:
+    bool DispatchStaticCall(std::string_view className, std::string_view functionName, RE::FormID target,
+                            std::uint16_t effectId, std::vector<Argument> args, ResultCallback callback) override {
+        auto* vm = RE::BSScript::Internal::VirtualMachine::GetSingleton();
+        if (!vm) {
+            logger::error("PapyrusVM: Failed to get VM singleton");
+            return false;
+        }
+
+        auto* actor = RE::TESForm::LookupByID<RE::Actor>(target);
+        auto* effect = ScriptPoolManager::FindActiveEffect(actor, effectId);
+        if (!actor || !effect) {
+            logger::error("PapyrusVM: target {:08X} no longer holds effect {} for {}", target, effectId, functionName);
+            return false;
+        }
+
+        auto& pool = TokenPool::GetSingleton();
+        std::vector<RE::BSFixedString> params;
+        params.reserve(args.size());
+        for (const auto& arg : args) {
+            // literals were pooled when their script loaded; anything else is a runtime value built fresh
+            if (arg.literal) {
+                params.push_back(*pool.Intern(arg.text));
+            } else {
+                params.emplace_back(arg.text);
+            }
+        }
+        auto* functionArgs = RE::MakeFunctionArguments(static_cast<RE::Actor*>(actor), static_cast<RE::ActiveEffect*>(effect),
+                                                       std::move(params));
+
+        RE::BSTSmartPointer<RE::BSScript::IStackCallbackFunctor> functor;
+        if (callback) {
+            functor = RE::make_smart<ResultCallbackFunctor>([callback = std::move(callback)](const RE::BSScript::Variable& result) {
+                callback(VariableToString(result));
+            });
+        }
+        return vm->DispatchStaticCall(*pool.Intern(className), *pool.Intern(functionName), functionArgs, functor);
+    }
+
+    bool GetOperationFunctions(std::string_view scriptName, std::vector<std::string>& operations) override {
+        auto* vm = RE::BSScript::Internal::VirtualMachine::GetSingleton();
+        if (!vm) {
+            return false;
+        }
+
+        RE::BSTSmartPointer<RE::BSScript::ObjectTypeInfo> typeinfoptr;
+        bool success = false;
+        try {
+            success = vm->GetScriptObjectType(RE::BSFixedString(scriptName), typeinfoptr);
+        } catch (...) {
+            //logger::info("exception?"); // this never gets called
+        }
+        if (!success) {
+            return false;
+        }
+
+        int numglobs = typeinfoptr->GetNumGlobalFuncs();
+        auto globiter = typeinfoptr->GetGlobalFuncIter();
+
+        for (int i = 0; i < numglobs; i++) {
+            auto libfunc = globiter[i].func;
+
+            if (libfunc->GetParamCount() != 3) {
+                continue;
+            }
+
+            RE::BSFixedString paramName;
+            RE::BSScript::TypeInfo paramTypeInfo;
+
+            libfunc->GetParam(0, paramName, paramTypeInfo);
+
+            std::string Actor_name("Actor");
+            if (!paramTypeInfo.IsObject() && Actor_name != paramTypeInfo.TypeAsString()) {
+                continue;
+            }
+
+            libfunc->GetParam(1, paramName, paramTypeInfo);
+
+            std::string ActiveMagicEffect_name("ActiveMagicEffect");
+            if (!paramTypeInfo.IsObject() && ActiveMagicEffect_name != paramTypeInfo.TypeAsString()) {
+                continue;
+            }
+
+            libfunc->GetParam(2, paramName, paramTypeInfo);
+
+            if (paramTypeInfo.GetRawType() != RE::BSScript::TypeInfo::RawType::kStringArray) {
+                continue;
+            }
+
+            operations.emplace_back(libfunc->GetName().c_str());
+        }
+        return true;
+    }
+
+    bool GetMagicEffects(RE::FormID target, std::vector<RE::FormID>& effects) override {
+        auto* actor = RE::TESForm::LookupByID<RE::Actor>(target);
+        auto* magicTarget = actor ? actor->AsMagicTarget() : nullptr;
+        if (!magicTarget) {
+            return false;
+        }
+        if (auto* active = magicTarget->GetActiveEffectList()) {
+            for (auto* effect : *active) {
+                if (auto* base = effect ? effect->GetBaseObject() : nullptr) {
+                    effects.push_back(base->GetFormID());
+                }
+            }
+        }
+        return true;
+    }
+
+    bool HasActiveEffect(RE::FormID target, std::uint16_t effectId) override {
+        return ScriptPoolManager::FindActiveEffect(RE::TESForm::LookupByID<RE::TESObjectREFR>(target), effectId) != nullptr;
+    }
+
+    bool CastSpell(RE::FormID target, RE::FormID spell) override {
+        auto* actor = RE::TESForm::LookupByID<RE::Actor>(target);
+        auto* spellItem = RE::TESForm::LookupByID<RE::SpellItem>(spell);
+        auto* magicCaster = actor ? actor->GetMagicCaster(RE::MagicSystem::CastingSource::kInstant) : nullptr;
+        if (!magicCaster || !spellItem) {
+            return false;
+        }
+        magicCaster->CastSpellImmediate(spellItem, false, actor, 1.0f, false, 0.0f, actor);
+        return true;
+    }
+};
+
+GamePapyrusVM gameVM;
+PapyrusVM* installedVM = &gameVM;
+}
+
+PapyrusVM& PapyrusVM::Get() {
+    return *installedVM;
+}
+
+void PapyrusVM::SetInstance(PapyrusVM* vm) {
+    installedVM = vm ? vm : &gameVM;
+}
+#pragma endregion
+}
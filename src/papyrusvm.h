@@ -0,0 +1,52 @@
+#pragma once
+
+namespace SLT {
+
+#pragma region PapyrusVM
+// The VM and magic-system calls the native layers make to start and drive SLT scripts:
+// OperationRunner's static dispatch, the operation lookup in FunctionLibrary::PrecacheLibraries,
+// ScriptPoolManager's effect occupancy checks and casts, and the check a ScriptContext makes that
+// its effect is still active before each dispatch. Everything goes through Get(), which
+// is the game implementation unless SetInstance installed another (e.g. the FakePapyrusVM in
+// tests/). Only form ids and strings cross this interface; building game objects, VM arguments
+// and BSFixedStrings is left to the game implementation.
+class PapyrusVM {
+public:
+    // One element of the string[] an operation receives. Literal arguments are script tokens
+    // passed on verbatim, so an implementation may reuse whatever it builds for them.
+    struct Argument {
+        std::string text;
+        bool literal = false;
+    };
+
+    // Runs when a dispatched call returns, with its return value as Papyrus would print it
+    using ResultCallback = std::function<void(std::string result)>;
+
+    virtual ~PapyrusVM() = default;
+
+    static PapyrusVM& Get();
+
+    // Not synchronized: swap before any script runs. nullptr restores the game implementation.
+    static void SetInstance(PapyrusVM* vm);
+
+    // Calls className.functionName(target, its active effect effectId, args) as an SLT operation;
+    // false if the call could not be queued. callback may be empty.
+    virtual bool DispatchStaticCall(std::string_view className, std::string_view functionName, RE::FormID target,
+                                    std::uint16_t effectId, std::vector<Argument> args, ResultCallback callback) = 0;
+
+    // Appends the global functions of scriptName shaped like an SLT operation,
+    // (Actor, ActiveEffect, string[]); false if the script type is not known to the VM
+    virtual bool GetOperationFunctions(std::string_view scriptName, std::vector<std::string>& operations) = 0;
+
+    // Appends the base effect of every effect active on target; false if target cannot hold
+    // magic effects at all
+    virtual bool GetMagicEffects(RE::FormID target, std::vector<RE::FormID>& effects) = 0;
+
+    // True if target still holds the active effect with unique id effectId
+    virtual bool HasActiveEffect(RE::FormID target, std::uint16_t effectId) = 0;
+
+    // Casts spell on target from target, instantly; false if the actor has no caster
+    virtual bool CastSpell(RE::FormID target, RE::FormID spell) = 0;
+};
+#pragma endregion
+}
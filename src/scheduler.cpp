@@ -0,0 +1,308 @@
+#include "scheduler.h"
+#include "taskqueue.h"
+
+namespace SLT {
+
+#pragma region TimerWheel
+void TimerWheel::Reset(std::uint64_t nowTick) {
+    for (auto& level : levels) {
+        for (auto& bucket : level) {
+            bucket.clear();
+        }
+    }
+    overflow.clear();
+    current = nowTick;
+    count = 0;
+}
+
+void TimerWheel::Add(TimerId id, std::uint64_t deadlineTick) {
+    // anything already due fires on the next tick
+    Place({ id, std::max(deadlineTick, current + 1) });
+    count++;
+}
+
+void TimerWheel::Place(const Entry& entry) {
+    std::uint64_t delta = entry.deadline - current;
+    for (std::size_t level = 0; level < kLevels; ++level) {
+        std::size_t shift = kSlotBits * level;
+        if (delta < (std::uint64_t{ 1 } << (shift + kSlotBits))) {
+            levels[level][(entry.deadline >> shift) & (kSlots - 1)].push_back(entry);
+            return;
+        }
+    }
+    overflow.push_back(entry);
+}
+
+void TimerWheel::Cascade(std::size_t level) {
+    if (level >= kLevels) {
+        Bucket pending;
+        pending.swap(overflow);
+        for (const auto& entry : pending) {
+            Place(entry);
+        }
+        return;
+    }
+
+    std::size_t shift = kSlotBits * level;
+    std::size_t index = (current >> shift) & (kSlots - 1);
+    if (index == 0) {
+        Cascade(level + 1);
+    }
+
+    Bucket pending;
+    pending.swap(levels[level][index]);
+    for (const auto& entry : pending) {
+        Place(entry);
+    }
+}
+
+void TimerWheel::Advance(std::uint64_t nowTick, std::vector<TimerId>& due) {
+    if (nowTick <= current || count == 0) {
+        current = std::max(current, nowTick);
+        return;
+    }
+    if (nowTick - current > kRebuildThreshold) {
+        Rebuild(nowTick, due);
+        return;
+    }
+
+    while (current < nowTick) {
+        current++;
+        std::size_t index = current & (kSlots - 1);
+        if (index == 0) {
+            Cascade(1);
+        }
+
+        auto& bucket = levels[0][index];
+        for (const auto& entry : bucket) {
+            due.push_back(entry.id);
+        }
+        count -= bucket.size();
+        bucket.clear();
+    }
+}
+
+void TimerWheel::Rebuild(std::uint64_t nowTick, std::vector<TimerId>& due) {
+    Bucket all;
+    all.reserve(count);
+    for (auto& level : levels) {
+        for (auto& bucket : level) {
+            all.insert(all.end(), bucket.begin(), bucket.end());
+            bucket.clear();
+        }
+    }
+    all.insert(all.end(), overflow.begin(), overflow.end());
+    overflow.clear();
+
+    current = nowTick;
+    count = 0;
+    for (const auto& entry : all) {
+        if (entry.deadline <= nowTick) {
+            due.push_back(entry.id);
+        } else {
+            Place(entry);
+            count++;
+        }
+    }
+}
+#pragma endregion
+
+#pragma region WaitScheduler
+namespace {
+struct MainUpdateHook {
+    static void thunk(RE::Main* a_this, float a_arg) {
+        func(a_this, a_arg);
+
+        static auto lastFrame = std::chrono::steady_clock::now();
+        auto now = std::chrono::steady_clock::now();
+        float frameSeconds = std::chrono::duration<float>(now - lastFrame).count();
+        lastFrame = now;
+
+        auto* ui = RE::UI::GetSingleton();
+        bool paused = ui && ui->GameIsPaused();
+        WaitScheduler::GetSingleton().Drain(frameSeconds, paused);
+        // after the waits, so work queued by scripts they resumed can start this frame
+        MainThreadQueue::GetSingleton().RunFrame();
+    }
+
+    static inline REL::Relocation<decltype(thunk)> func;
+};
+}
+
+void WaitScheduler::Install() {
+    SKSE::AllocTrampoline(14);
+    REL::Relocation<std::uintptr_t> target{ RELOCATION_ID(35565, 36564), REL::Relocate(0x748, 0xC26, 0x7EE) };
+    MainUpdateHook::func = SKSE::GetTrampoline().write_call<5>(target.address(), MainUpdateHook::thunk);
+    logger::info("WaitScheduler: main loop hook installed");
+}
+
+std::uint64_t WaitScheduler::RealNowTick() const {
+    return static_cast<std::uint64_t>(realTime * kRealTicksPerSecond);
+}
+
+std::uint64_t WaitScheduler::GameNowTick() {
+    auto* calendar = RE::Calendar::GetSingleton();
+    if (!calendar) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>(static_cast<double>(calendar->GetCurrentGameTime()) * kGameTicksPerDay);
+}
+
+WaitScheduler::Callback WaitScheduler::LatentReturn(RE::VMStackID stackId) {
+    return [stackId]() {
+        if (auto* vm = RE::BSScript::Internal::VirtualMachine::GetSingleton()) {
+            vm->ReturnLatentResult<bool>(stackId, true);
+        }
+    };
+}
+
+TimerId WaitScheduler::Schedule(Clock clock, std::uint64_t deadlineTick, Callback callback, std::optional<RE::VMStackID> latentStack) {
+    TimerId id = nextId++;
+    pending.emplace(id, Pending{ clock, std::move(callback), deadlineTick, latentStack });
+    (clock == Clock::RealTime ? realWheel : gameWheel).Add(id, deadlineTick);
+    return id;
+}
+
+std::uint64_t WaitScheduler::SyncGameWheelLocked() {
+    std::uint64_t now = GameNowTick();
+    if (!gameWheelSynced) {
+        gameWheel.Reset(now);
+        gameWheelSynced = true;
+    }
+    return now;
+}
+
+std::uint64_t WaitScheduler::DeadlineLocked(Clock clock, float amount) {
+    if (clock == Clock::RealTime) {
+        return RealNowTick() + static_cast<std::uint64_t>(std::max(0.0f, amount) * kRealTicksPerSecond);
+    }
+    return SyncGameWheelLocked() + static_cast<std::uint64_t>(std::max(0.0f, amount) * (kGameTicksPerDay / 24.0));
+}
+
+TimerId WaitScheduler::ScheduleRealTime(float seconds, Callback callback) {
+    std::lock_guard lock(mutex);
+    return Schedule(Clock::RealTime, DeadlineLocked(Clock::RealTime, seconds), std::move(callback));
+}
+
+TimerId WaitScheduler::ScheduleGameTime(float gameHours, Callback callback) {
+    std::lock_guard lock(mutex);
+    return Schedule(Clock::GameTime, DeadlineLocked(Clock::GameTime, gameHours), std::move(callback));
+}
+
+TimerId WaitScheduler::ScheduleLatentReturn(Clock clock, float amount, RE::VMStackID stackId) {
+    std::lock_guard lock(mutex);
+    return Schedule(clock, DeadlineLocked(clock, amount), LatentReturn(stackId), stackId);
+}
+
+bool WaitScheduler::Cancel(TimerId id) {
+    std::lock_guard lock(mutex);
+    // the wheel entry stays behind and is skipped when it comes due
+    return pending.erase(id) > 0;
+}
+
+void WaitScheduler::Clear() {
+    std::lock_guard lock(mutex);
+    // latent stacks go with the VM state being left; those in the save come back through Load
+    if (!pending.empty()) {
+        logger::info("WaitScheduler: dropping {} pending waits from the previous session", pending.size());
+    }
+    pending.clear();
+    realWheel.Reset(RealNowTick());
+    gameWheel.Reset(0);
+    gameWheelSynced = false;
+}
+
+void WaitScheduler::Drain(float frameSeconds, bool paused) {
+    std::vector<Callback> ready;
+    {
+        std::lock_guard lock(mutex);
+        if (!paused) {
+            realTime += frameSeconds;
+        }
+        std::vector<TimerId> due;
+        realWheel.Advance(RealNowTick(), due);
+        if (gameWheelSynced) {
+            gameWheel.Advance(GameNowTick(), due);
+        }
+
+        ready.reserve(due.size());
+        for (auto id : due) {
+            auto it = pending.find(id);
+            if (it != pending.end()) {
+                ready.push_back(std::move(it->second.callback));
+                pending.erase(it);
+            }
+        }
+    }
+
+    // callbacks may schedule again, so they run without the lock held
+    for (auto& callback : ready) {
+        callback();
+    }
+}
+
+void WaitScheduler::Save(SKSE::SerializationInterface* intfc) {
+    std::lock_guard lock(mutex);
+    const std::uint64_t realNow = RealNowTick();
+    const auto count = static_cast<std::uint32_t>(std::ranges::count_if(pending, [](const auto& entry) {
+        return entry.second.latentStack.has_value();
+    }));
+    if (!intfc->OpenRecord(kRecord, kRecordVersion) || !intfc->WriteRecordData(count)) {
+        logger::error("WaitScheduler: failed to write wait record");
+        return;
+    }
+    for (const auto& [id, wait] : pending) {
+        if (!wait.latentStack) {
+            continue;
+        }
+        // the real-time clock starts over with each launch, the calendar is saved with the game
+        std::uint64_t when = wait.deadline;
+        if (wait.clock == Clock::RealTime) {
+            when = wait.deadline > realNow ? wait.deadline - realNow : 0;
+        }
+        if (!intfc->WriteRecordData(*wait.latentStack) || !intfc->WriteRecordData(wait.clock) || !intfc->WriteRecordData(when)) {
+            logger::error("WaitScheduler: failed to write wait {}", id);
+            return;
+        }
+    }
+}
+
+void WaitScheduler::Load(SKSE::SerializationInterface* intfc, std::uint32_t version) {
+    if (version != kRecordVersion) {
+        logger::error("WaitScheduler: unsupported record version {}", version);
+        return;
+    }
+
+    std::lock_guard lock(mutex);
+    std::uint32_t count = 0;
+    intfc->ReadRecordData(count);
+    std::uint32_t rearmed = 0;
+    for (; rearmed < count; ++rearmed) {
+        RE::VMStackID stackId = 0;
+        Clock clock = Clock::RealTime;
+        std::uint64_t when = 0;
+        if (!intfc->ReadRecordData(stackId) || !intfc->ReadRecordData(clock) || !intfc->ReadRecordData(when)) {
+            logger::error("WaitScheduler: failed to read wait {} of {}", rearmed + 1, count);
+            break;
+        }
+        if (clock == Clock::RealTime) {
+            Schedule(clock, RealNowTick() + when, LatentReturn(stackId), stackId);
+        } else {
+            SyncGameWheelLocked();
+            Schedule(clock, when, LatentReturn(stackId), stackId);
+        }
+    }
+    logger::info("WaitScheduler: re-armed {} waits from the save", rearmed);
+}
+
+std::size_t WaitScheduler::PendingCount() const {
+    std::lock_guard lock(mutex);
+    return pending.size();
+}
+
+double WaitScheduler::RealTimeSeconds() const {
+    std::lock_guard lock(mutex);
+    return realTime;
+}
+#pragma endregion
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+namespace SLT {
+
+typedef std::uint64_t TimerId;
+constexpr TimerId INVALID_TIMER = 0;
+
+#pragma region TimerWheel
+// Hierarchical timer wheel over an abstract tick counter. Each level has kSlots buckets, each
+// covering kSlots times the span of a bucket on the level below; timers cascade down a level as
+// the wheel reaches their bucket, so an idle timer costs nothing until its bucket comes due.
+// Timers beyond the top level wait in an overflow list that is re-sorted once per top-level turn.
+class TimerWheel {
+public:
+    static constexpr std::size_t kLevels = 4;
+    static constexpr std::size_t kSlotBits = 6;
+    static constexpr std::size_t kSlots = std::size_t{ 1 } << kSlotBits;
+
+    // Jumps further than this are handled by re-sorting every timer instead of walking each tick
+    static constexpr std::uint64_t kRebuildThreshold = kSlots * kSlots;
+
+    void Reset(std::uint64_t nowTick);
+    void Add(TimerId id, std::uint64_t deadlineTick);
+
+    // Moves the wheel to nowTick, appending every timer whose deadline has passed to due
+    void Advance(std::uint64_t nowTick, std::vector<TimerId>& due);
+
+    std::uint64_t Now() const { return current; }
+    std::size_t Size() const { return count; }
+
+private:
+    struct Entry {
+        TimerId id;
+        std::uint64_t deadline;
+    };
+    using Bucket = std::vector<Entry>;
+
+    std::array<std::array<Bucket, kSlots>, kLevels> levels;
+    Bucket overflow;
+    std::uint64_t current = 0;
+    std::size_t count = 0;
+
+    void Place(const Entry& entry);
+    void Cascade(std::size_t level);
+    void Rebuild(std::uint64_t nowTick, std::vector<TimerId>& due);
+};
+#pragma endregion
+
+#pragma region WaitScheduler
+// Native home for SLT script waits and delayed operations, woken by a drain that runs once per
+// frame on the main thread. A Papyrus script waiting in the latent NativeWait/NativeWaitGameTime
+// still holds its suspended VM stack, exactly as it would in Utility.Wait; only scripts run as a
+// native ScriptContext give up their stack while they wait, parking a callback here instead.
+//
+// Real time follows Utility.Wait: it only advances while the game is not paused. Game time is
+// read from the calendar in game seconds. Timers belong to the session that created them and are
+// dropped when a game is loaded or started, except latent returns: the VM saves their stacks with
+// the game, so they are kept in the cosave and re-armed when that save is loaded.
+class WaitScheduler {
+public:
+    using Callback = std::function<void()>;
+
+    static constexpr std::uint32_t kRecord = 'WAIT';
+    static constexpr std::uint32_t kRecordVersion = 1;
+
+    enum class Clock : std::uint8_t {
+        RealTime,
+        GameTime
+    };
+
+    static WaitScheduler& GetSingleton() {
+        static WaitScheduler singleton;
+        return singleton;
+    }
+
+    // Hooks the main loop so Drain() and MainThreadQueue::RunFrame() run once per frame
+    static void Install();
+
+    TimerId ScheduleRealTime(float seconds, Callback callback);
+    TimerId ScheduleGameTime(float gameHours, Callback callback);
+
+    // Returns true to a latent native's suspended stack once amount (seconds or game hours) elapses
+    TimerId ScheduleLatentReturn(Clock clock, float amount, RE::VMStackID stackId);
+
+    bool Cancel(TimerId id);
+    void Clear();
+
+    // Cosave record of the pending latent returns, written and read from VariableStore's
+    // serialization callbacks; real time is kept as what is left, game time as its deadline
+    void Save(SKSE::SerializationInterface* intfc);
+    void Load(SKSE::SerializationInterface* intfc, std::uint32_t version);
+
+    // Advances both clocks and runs every callback that came due; main thread only
+    void Drain(float frameSeconds, bool paused);
+
+    std::size_t PendingCount() const;
+
+    // The real-time clock: unpaused seconds since the scheduler was created
+    double RealTimeSeconds() const;
+
+private:
+    static constexpr double kRealTicksPerSecond = 1000.0; // 1 ms resolution
+    static constexpr double kGameTicksPerDay = 86400.0;   // 1 game second resolution
+
+    struct Pending {
+        Clock clock;
+        Callback callback;
+        std::uint64_t deadline;
+        std::optional<RE::VMStackID> latentStack; // set for latent returns, which are saved
+    };
+
+    mutable std::mutex mutex;
+    TimerWheel realWheel;
+    TimerWheel gameWheel;
+    std::unordered_map<TimerId, Pending> pending;
+    TimerId nextId = 1;
+    double realTime = 0.0;   // unpaused seconds since the scheduler was created
+    bool gameWheelSynced = false;
+
+    TimerId Schedule(Clock clock, std::uint64_t deadlineTick, Callback callback, std::optional<RE::VMStackID> latentStack = std::nullopt);
+    std::uint64_t DeadlineLocked(Clock clock, float amount);
+    std::uint64_t SyncGameWheelLocked();
+    std::uint64_t RealNowTick() const;
+    static std::uint64_t GameNowTick();
+    static Callback LatentReturn(RE::VMStackID stackId);
+
+    WaitScheduler() = default;
+    WaitScheduler(const WaitScheduler&) = delete;
+    WaitScheduler& operator=(const WaitScheduler&) = delete;
+};
+#pragma endregion
+}
@@ -0,0 +1,721 @@
+#include "script.h"
+#include "expression.h"
+#include "optimizer.h"
+#include "sl_triggers.h"
+#include "workerpool.h"
+
+namespace SLT {
+
+#pragma region LoadedScript
+std::int32_t LoadedScript::FindSlot(std::string_view varName) const {
+    auto it = slotIndex.find(std::string(varName));
+    return it != slotIndex.end() ? it->second : NO_SLOT;
+}
+
+std::int32_t LoadedScript::FindLabel(std::string_view label) const {
+    if (label.size() >= 2 && label.front() == '[' && label.back() == ']') {
+        label = label.substr(1, label.size() - 2);
+    }
+    auto it = labels.find(std::string(label));
+    return it != labels.end() ? it->second : NO_JUMP;
+}
+#pragma endregion
+
+#pragma region ScriptLibrary
+namespace {
+bool IsBracketedLabel(std::string_view token) {
+    return token.size() >= 2 && token.front() == '[' && token.back() == ']';
+}
+
+enum class BlockKind {
+    If,
+    While,
+    Sub
+};
+
+struct OpenBlock {
+    BlockKind kind;
+    std::int32_t start;
+    std::int32_t lastClause;        // if: the clause whose false-branch jump is still open
+    bool sawElse;
+    std::pmr::vector<std::int32_t> clauses; // if: every if/elseif/else line, for blockEnd
+    std::pmr::vector<std::int32_t> breaks;  // while: break lines waiting for the endwhile
+};
+
+// Per-thread buffers every load on that thread reuses: the file text keeps the capacity of the
+// largest script read so far, and the arena block backs each load's scratch allocations
+struct LoadScratch {
+    static constexpr std::size_t kArenaBytes = 16 * 1024;
+
+    std::string contents;
+    std::array<std::byte, kArenaBytes> arena;
+};
+
+LoadScratch& GetLoadScratch() {
+    thread_local LoadScratch scratch;
+    return scratch;
+}
+
+// Reads the whole file into contents, reusing its capacity
+bool ReadFileInto(const fs::path& filepath, std::string& contents) {
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.good()) {
+        return false;
+    }
+    const auto size = file.tellg();
+    if (size < 0) {
+        return false;
+    }
+    file.seekg(0);
+    contents.resize(static_cast<std::size_t>(size));
+    file.read(contents.data(), static_cast<std::streamsize>(size));
+    contents.resize(static_cast<std::size_t>(file.gcount()));
+    return true;
+}
+
+std::string_view TrimView(std::string_view text) {
+    auto isSpace = [](unsigned char ch) { return std::isspace(ch); };
+    auto start = std::find_if_not(text.begin(), text.end(), isSpace);
+    auto end = std::find_if_not(text.rbegin(), std::make_reverse_iterator(start), isSpace).base();
+    return std::string_view(start, end);
+}
+}
+
+void ScriptLibrary::BuildControlFlow(LoadedScript& script, std::pmr::memory_resource* scratch) {
+    auto& lines = script.lines;
+    script.labels.clear();
+    script.subroutines.clear();
+    script.diagnostics.clear();
+    for (auto& line : lines) {
+        line.jumpTarget = NO_JUMP;
+        line.blockEnd = NO_JUMP;
+    }
+
+    auto diag = [&script, &lines](std::int32_t index, std::string message) {
+        script.diagnostics.push_back(std::format("{}({}): {}", script.name, lines[index].lineNo, message));
+    };
+
+    // labels and subroutine names first, so forward references resolve
+    for (std::int32_t i = 0; i < static_cast<std::int32_t>(lines.size()); ++i) {
+        const auto& tokens = lines[i].tokens;
+        if (IsBracketedLabel(tokens[0])) {
+            std::string label = tokens[0].substr(1, tokens[0].size() - 2);
+            if (!script.labels.try_emplace(label, i).second) {
+                diag(i, std::format("duplicate label [{}]", label));
+            }
+        } else if (str::iEquals(tokens[0], "beginsub")) {
+            if (tokens.size() < 2) {
+                diag(i, "beginsub without a name");
+            } else if (!script.subroutines.try_emplace(tokens[1], i).second) {
+                diag(i, std::format("duplicate subroutine '{}'", tokens[1]));
+            }
+        }
+    }
+
+    std::pmr::vector<OpenBlock> blocks(scratch);
+    auto open = [&blocks, scratch](BlockKind kind, std::int32_t start) -> OpenBlock& {
+        return blocks.emplace_back(OpenBlock{ kind, start, start, false, std::pmr::vector<std::int32_t>(scratch),
+                                              std::pmr::vector<std::int32_t>(scratch) });
+    };
+    auto innermost = [&blocks](BlockKind kind) -> OpenBlock* {
+        for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+            if (it->kind == kind) {
+                return &*it;
+            }
+        }
+        return nullptr;
+    };
+
+    for (std::int32_t i = 0; i < static_cast<std::int32_t>(lines.size()); ++i) {
+        auto& line = lines[i];
+        const auto& tokens = line.tokens;
+        const std::string& cmd = tokens[0];
+
+        if (str::iEquals(cmd, "goto") || str::iEquals(cmd, "gosub")) {
+            if (tokens.size() < 2) {
+                diag(i, std::format("{} without a target", cmd));
+                continue;
+            }
+            if (tokens[1].find('$') != std::string::npos) {
+                continue; // computed target, resolved at runtime
+            }
+            std::int32_t target = NO_JUMP;
+            if (str::iEquals(cmd, "gosub")) {
+                auto sub = script.subroutines.find(tokens[1]);
+                if (sub != script.subroutines.end()) {
+                    target = sub->second;
+                }
+            }
+            if (target == NO_JUMP) {
+                target = script.FindLabel(tokens[1]);
+            }
+            if (target == NO_JUMP) {
+                diag(i, std::format("{} target '{}' not found", cmd, tokens[1]));
+            }
+            line.jumpTarget = target;
+        } else if (str::iEquals(cmd, "if")) {
+            // "if <cond> [label]" (or a bare known label) is a conditional jump, not a block
+            const std::string& last = tokens.back();
+            bool jumpForm = tokens.size() >= 3 && IsBracketedLabel(last);
+            if (!jumpForm && tokens.size() >= 5 && script.FindLabel(last) != NO_JUMP) {
+                jumpForm = true;
+            }
+            if (jumpForm) {
+                line.jumpTarget = script.FindLabel(last);
+                if (line.jumpTarget == NO_JUMP) {
+                    diag(i, std::format("if target '{}' not found", last));
+                }
+            } else {
+                open(BlockKind::If, i).clauses.push_back(i);
+            }
+        } else if (str::iEquals(cmd, "elseif") || str::iEquals(cmd, "else")) {
+            if (blocks.empty() || blocks.back().kind != BlockKind::If) {
+                diag(i, std::format("{} without a matching if", cmd));
+                continue;
+            }
+            auto& block = blocks.back();
+            if (block.sawElse) {
+                diag(i, std::format("{} after else", cmd));
+                continue;
+            }
+            lines[block.lastClause].jumpTarget = i;
+            block.lastClause = i;
+            block.clauses.push_back(i);
+            block.sawElse = str::iEquals(cmd, "else");
+        } else if (str::iEquals(cmd, "endif")) {
+            if (blocks.empty() || blocks.back().kind != BlockKind::If) {
+                diag(i, "endif without a matching if");
+                continue;
+            }
+            auto& block = blocks.back();
+            lines[block.lastClause].jumpTarget = i;
+            for (auto clause : block.clauses) {
+                lines[clause].blockEnd = i;
+            }
+            blocks.pop_back();
+        } else if (str::iEquals(cmd, "while")) {
+            open(BlockKind::While, i);
+        } else if (str::iEquals(cmd, "endwhile")) {
+            if (blocks.empty() || blocks.back().kind != BlockKind::While) {
+                diag(i, "endwhile without a matching while");
+                continue;
+            }
+            auto& block = blocks.back();
+            lines[block.start].jumpTarget = i;
+            line.jumpTarget = block.start;
+            for (auto brk : block.breaks) {
+                lines[brk].jumpTarget = i;
+            }
+            blocks.pop_back();
+        } else if (str::iEquals(cmd, "break") || str::iEquals(cmd, "continue")) {
+            auto* loop = innermost(BlockKind::While);
+            if (!loop) {
+                diag(i, std::format("{} outside of a while loop", cmd));
+            } else if (str::iEquals(cmd, "break")) {
+                loop->breaks.push_back(i);
+            } else {
+                line.jumpTarget = loop->start;
+            }
+        } else if (str::iEquals(cmd, "beginsub")) {
+            if (innermost(BlockKind::Sub)) {
+                diag(i, "beginsub inside another subroutine");
+            }
+            open(BlockKind::Sub, i);
+        } else if (str::iEquals(cmd, "endsub")) {
+            if (blocks.empty() || blocks.back().kind != BlockKind::Sub) {
+                diag(i, "endsub without a matching beginsub");
+                continue;
+            }
+            lines[blocks.back().start].jumpTarget = i;
+            blocks.pop_back();
+        }
+    }
+
+    for (const auto& block : blocks) {
+        switch (block.kind) {
+            case BlockKind::If:     diag(block.start, "if without a matching endif"); break;
+            case BlockKind::While:  diag(block.start, "while without a matching endwhile"); break;
+            case BlockKind::Sub:    diag(block.start, "beginsub without a matching endsub"); break;
+        }
+    }
+
+    for (const auto& message : script.diagnostics) {
+        logger::error("{}", message);
+    }
+}
+
+bool ScriptLibrary::IsSlottedVariable(std::string_view varName) {
+    if (varName.empty()) {
+        return false;
+    }
+    return std::all_of(varName.begin(), varName.end(), [](unsigned char c) { return std::isalnum(c) || c == '_'; });
+}
+
+bool ScriptLibrary::IsScopedVariable(std::string_view varName) {
+    return varName.find('.') != std::string_view::npos;
+}
+
+std::shared_ptr<LoadedScript> ScriptLibrary::Parse(std::string_view scriptfilename, const fs::path& filepath) {
+    auto& loadScratch = GetLoadScratch();
+    if (!ReadFileInto(filepath, loadScratch.contents)) {
+        return nullptr;
+    }
+    const std::string_view contents = loadScratch.contents;
+
+    // Everything the load needs only while it runs comes from this arena and is released in one
+    // go on return; only what the LoadedScript keeps is allocated from the heap
+    std::pmr::monotonic_buffer_resource arena(loadScratch.arena.data(), loadScratch.arena.size());
+
+    auto script = std::make_shared<LoadedScript>();
+    script->name = std::string(scriptfilename);
+
+    std::error_code ec;
+    script->lastWriteTime = fs::last_write_time(filepath, ec);
+
+    auto assignSlot = [&script](std::string_view varName) -> std::int32_t {
+        if (!IsSlottedVariable(varName)) {
+            return NO_SLOT;
+        }
+        auto [it, inserted] = script->slotIndex.try_emplace(std::string(varName), script->SlotCount());
+        if (inserted) {
+            script->slotNames.emplace_back(varName);
+        }
+        return it->second;
+    };
+
+    script->lines.reserve(static_cast<std::size_t>(std::ranges::count(contents, '\n')) + 1);
+    std::pmr::vector<std::string_view> linetokens(&arena);
+
+    std::int32_t lineno = 0;
+    for (std::size_t lineStart = 0; lineStart < contents.size();) {
+        const auto lineEnd = std::min(contents.find('\n', lineStart), contents.size());
+        auto line = TrimView(contents.substr(lineStart, lineEnd - lineStart));
+        lineStart = lineEnd + 1;
+        lineno++;
+
+        line = line.substr(0, line.find(';'));
+
+        linetokens.clear();
+        SLTNativeFunctions::Tokenizev2(line, linetokens);
+        if (linetokens.empty()) {
+            continue;
+        }
+
+        ScriptLine& scriptLine = script->lines.emplace_back();
+        scriptLine.lineNo = lineno;
+        scriptLine.slots.reserve(linetokens.size());
+
+        for (const auto& token : linetokens) {
+            std::int32_t slot = NO_SLOT;
+            if (token.size() > 1 && token[0] == '$') {
+                if (token[1] == '"') {
+                    // interpolated string: its {name} references still get slots, the token itself does not
+                    for (const auto& piece : SLTNativeFunctions::TokenizeForVariableSubstitution(token.substr(2))) {
+                        if (piece.isVariable) {
+                            assignSlot(piece.text);
+                        }
+                    }
+                } else {
+                    slot = assignSlot(token.substr(1));
+                }
+            }
+            scriptLine.slots.push_back(slot);
+        }
+        scriptLine.tokens.assign(linetokens.begin(), linetokens.end());
+    }
+
+    BuildControlFlow(*script, &arena);
+    return script;
+}
+
+std::shared_ptr<LoadedScript> ScriptLibrary::Load(std::string_view scriptfilename, const fs::path& filepath) {
+    auto script = Parse(scriptfilename, filepath);
+    if (!script) {
+        return nullptr;
+    }
+    InternLiterals(*script);
+
+    logger::debug("ScriptLibrary: loaded {} ({} lines, {} variable slots)", scriptfilename, script->lines.size(), script->SlotCount());
+    return script;
+}
+
+void ScriptLibrary::InternLiterals(LoadedScript& script) {
+    auto& pool = TokenPool::GetSingleton();
+    for (auto& line : script.lines) {
+        line.literals.assign(line.tokens.size(), nullptr);
+        for (std::size_t i = 0; i < line.tokens.size(); ++i) {
+            const auto& token = line.tokens[i];
+            // matches what the runtime passes through unresolved: no slot, not a $ or " expression
+            if (line.slots[i] == NO_SLOT && (token.empty() || (token[0] != '$' && token[0] != '"'))) {
+                line.literals[i] = pool.Intern(token);
+            }
+        }
+    }
+}
+
+ScriptLibrary::Entry ScriptLibrary::GetEntry(std::string_view scriptfilename) {
+    fs::path filepath = GetScriptfilePath(scriptfilename);
+
+    std::error_code ec;
+    if (!fs::is_regular_file(filepath, ec)) {
+        return {};
+    }
+    auto lastWriteTime = fs::last_write_time(filepath, ec);
+
+    std::string key(scriptfilename);
+    {
+        std::shared_lock lock(mutex);
+        auto it = scripts.find(key);
+        if (it != scripts.end() && it->second.original->lastWriteTime == lastWriteTime) {
+            return it->second;
+        }
+    }
+
+    Entry entry;
+    entry.original = Load(scriptfilename, filepath);
+    if (!entry.original) {
+        return {};
+    }
+    // the optimized program is cached next to the original so either can be served without reloading
+    if (auto optimized = ScriptOptimizer::Optimize(*entry.original)) {
+        // the optimizer rewrites tokens, so the literals copied from the original may be stale
+        InternLiterals(*optimized);
+        entry.optimized = std::move(optimized);
+    }
+
+    ExpressionCache::GetSingleton().Invalidate(scriptfilename);
+
+    std::unique_lock lock(mutex);
+    scripts[key] = entry;
+    return entry;
+}
+
+std::shared_ptr<const LoadedScript> ScriptLibrary::Get(std::string_view scriptfilename) {
+    Entry entry = GetEntry(scriptfilename);
+    if (!entry.optimized || !IsOptimizationEnabled(scriptfilename)) {
+        return entry.original;
+    }
+    return entry.optimized;
+}
+
+std::shared_ptr<const LoadedScript> ScriptLibrary::GetOriginal(std::string_view scriptfilename) {
+    return GetEntry(scriptfilename).original;
+}
+
+void ScriptLibrary::SetOptimizationEnabled(std::string_view scriptfilename, bool enabled) {
+    std::unique_lock lock(mutex);
+    if (enabled) {
+        optimizationEnabled.emplace(scriptfilename);
+    } else {
+        optimizationEnabled.erase(std::string(scriptfilename));
+    }
+}
+
+bool ScriptLibrary::IsOptimizationEnabled(std::string_view scriptfilename) const {
+    std::shared_lock lock(mutex);
+    return optimizationEnabled.contains(std::string(scriptfilename));
+}
+
+void ScriptLibrary::Invalidate(std::string_view scriptfilename) {
+    {
+        std::unique_lock lock(mutex);
+        scripts.erase(std::string(scriptfilename));
+    }
+    ExpressionCache::GetSingleton().Invalidate(scriptfilename);
+}
+
+void ScriptLibrary::Clear() {
+    {
+        std::unique_lock lock(mutex);
+        scripts.clear();
+    }
+    ExpressionCache::GetSingleton().Clear();
+}
+#pragma endregion
+
+#pragma region ScriptHandleTable
+namespace {
+bool ReadString(SKSE::SerializationInterface* intfc, std::string& out) {
+    std::uint32_t length = 0;
+    if (!intfc->ReadRecordData(length)) {
+        return false;
+    }
+    out.resize(length);
+    return length == 0 || intfc->ReadRecordData(out.data(), length) == length;
+}
+}
+
+void ScriptHandleTable::Install() {
+    auto* holder = RE::ScriptEventSourceHolder::GetSingleton();
+    if (!holder) {
+        logger::error("ScriptHandleTable: event source holder unavailable, handles only release through CloseScriptHandle");
+        return;
+    }
+    holder->AddEventSink<RE::TESActiveEffectApplyRemoveEvent>(this);
+}
+
+ScriptHandle ScriptHandleTable::Open(std::string_view scriptfilename, RE::ActiveEffect* owner) {
+    auto script = ScriptLibrary::GetSingleton().Get(scriptfilename);
+    if (!script) {
+        logger::error("ScriptHandleTable: unable to load script ({})", scriptfilename);
+        return INVALID_SCRIPT_HANDLE;
+    }
+
+    Entry entry{ std::move(script), std::string(scriptfilename) };
+    if (auto* target = owner ? owner->GetTargetActor() : nullptr) {
+        entry.ownerTarget = target->GetFormID();
+        entry.ownerEffectId = owner->usUniqueID;
+        entry.owned = true;
+    }
+
+    std::unique_lock lock(mutex);
+    ScriptHandle handle = nextHandle++;
+    if (nextHandle <= 0) {
+        nextHandle = 1;
+    }
+    if (entry.owned) {
+        ownedCount.fetch_add(1, std::memory_order_release);
+    }
+    handles.insert_or_assign(handle, std::move(entry));
+    return handle;
+}
+
+void ScriptHandleTable::Close(ScriptHandle handle) {
+    std::unique_lock lock(mutex);
+    if (auto it = handles.find(handle); it != handles.end()) {
+        if (it->second.owned) {
+            ownedCount.fetch_sub(1, std::memory_order_release);
+        }
+        handles.erase(it);
+    }
+}
+
+std::shared_ptr<const LoadedScript> ScriptHandleTable::Resolve(ScriptHandle handle) {
+    std::string scriptfilename;
+    {
+        std::shared_lock lock(mutex);
+        auto it = handles.find(handle);
+        if (it == handles.end()) {
+            return nullptr;
+        }
+        if (it->second.script) {
+            return it->second.script;
+        }
+        scriptfilename = it->second.scriptfilename;
+    }
+
+    // restored by a load: pin whatever is on disk now, outside the lock since it may read the file
+    auto script = ScriptLibrary::GetSingleton().Get(scriptfilename);
+    if (!script) {
+        logger::error("ScriptHandleTable: unable to reload script ({}) for handle {}", scriptfilename, handle);
+        return nullptr;
+    }
+
+    std::unique_lock lock(mutex);
+    auto it = handles.find(handle);
+    if (it == handles.end()) {
+        return nullptr;
+    }
+    if (!it->second.script) {
+        it->second.script = std::move(script);
+    }
+    return it->second.script;
+}
+
+void ScriptHandleTable::Clear() {
+    std::unique_lock lock(mutex);
+    handles.clear();
+    ownedCount.store(0, std::memory_order_release);
+}
+
+void ScriptHandleTable::Save(SKSE::SerializationInterface* intfc) {
+    std::shared_lock lock(mutex);
+    if (!intfc->OpenRecord(kRecord, kRecordVersion) || !intfc->WriteRecordData(nextHandle) ||
+        !intfc->WriteRecordData(static_cast<std::uint32_t>(handles.size()))) {
+        logger::error("ScriptHandleTable: failed to write handle record");
+        return;
+    }
+    for (const auto& [handle, entry] : handles) {
+        const auto& name = entry.scriptfilename;
+        bool ok = intfc->WriteRecordData(handle) && intfc->WriteRecordData(entry.owned) &&
+                  intfc->WriteRecordData(entry.ownerTarget) && intfc->WriteRecordData(entry.ownerEffectId) &&
+                  intfc->WriteRecordData(static_cast<std::uint32_t>(name.size())) &&
+                  intfc->WriteRecordData(name.data(), static_cast<std::uint32_t>(name.size()));
+        if (!ok) {
+            logger::error("ScriptHandleTable: failed to write handle {}", handle);
+            return;
+        }
+    }
+}
+
+void ScriptHandleTable::Load(SKSE::SerializationInterface* intfc, std::uint32_t version) {
+    if (version != kRecordVersion) {
+        logger::error("ScriptHandleTable: unsupported record version {}", version);
+        return;
+    }
+
+    std::unique_lock lock(mutex);
+    handles.clear();
+
+    std::uint32_t count = 0;
+    if (!intfc->ReadRecordData(nextHandle) || !intfc->ReadRecordData(count)) {
+        logger::error("ScriptHandleTable: failed to read handle record");
+        nextHandle = 1;
+        return;
+    }
+    if (nextHandle <= 0) {
+        nextHandle = 1;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        ScriptHandle handle = INVALID_SCRIPT_HANDLE;
+        Entry entry;
+        bool ok = intfc->ReadRecordData(handle) && intfc->ReadRecordData(entry.owned) &&
+                  intfc->ReadRecordData(entry.ownerTarget) && intfc->ReadRecordData(entry.ownerEffectId) &&
+                  ReadString(intfc, entry.scriptfilename);
+        if (!ok) {
+            logger::error("ScriptHandleTable: failed to read handle record");
+            break;
+        }
+        // an owner from a plugin no longer loaded cannot still be running the script
+        if (entry.owned && !intfc->ResolveFormID(entry.ownerTarget, entry.ownerTarget)) {
+            continue;
+        }
+        handles.insert_or_assign(handle, std::move(entry));
+    }
+    RecountOwnedLocked();
+}
+
+void ScriptHandleTable::ValidateOwners() {
+    std::unique_lock lock(mutex);
+    const auto dropped = std::erase_if(handles, [](const auto& item) {
+        const auto& entry = item.second;
+        return entry.owned && !ScriptPoolManager::FindActiveEffect(RE::TESForm::LookupByID<RE::TESObjectREFR>(entry.ownerTarget),
+                                                                    entry.ownerEffectId);
+    });
+    RecountOwnedLocked();
+    if (dropped > 0) {
+        logger::info("ScriptHandleTable: released {} handles whose effect did not survive the load", dropped);
+    }
+}
+
+RE::BSEventNotifyControl ScriptHandleTable::ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event,
+                                                         RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>*) {
+    if (!a_event || a_event->isApplied || !a_event->target || ownedCount.load(std::memory_order_acquire) == 0) {
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    const auto target = a_event->target->GetFormID();
+    const auto effectId = a_event->activeEffectUniqueID;
+
+    std::unique_lock lock(mutex);
+    const auto released = std::erase_if(handles, [target, effectId](const auto& item) {
+        const auto& entry = item.second;
+        return entry.owned && entry.ownerTarget == target && entry.ownerEffectId == effectId;
+    });
+    ownedCount.fetch_sub(released, std::memory_order_release);
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+void ScriptHandleTable::RecountOwnedLocked() {
+    ownedCount.store(std::ranges::count_if(handles, [](const auto& item) { return item.second.owned; }),
+                     std::memory_order_release);
+}
+#pragma endregion
+
+#pragma region ScriptPrefetcher
+namespace {
+std::atomic<bool> prefetchQueued = false;
+}
+
+void ScriptPrefetcher::Schedule() {
+    if (prefetchQueued.exchange(true)) {
+        return;
+    }
+    WorkerPool::GetSingleton().Submit([]() {
+        auto scriptnames = CollectTriggerScripts();
+        prefetchQueued = false;
+
+        logger::info("ScriptPrefetcher: warming {} trigger scripts", scriptnames.size());
+        for (auto& scriptname : scriptnames) {
+            WorkerPool::GetSingleton().Submit([scriptname = std::move(scriptname)]() {
+                ScriptLibrary::GetSingleton().Get(scriptname);
+            }, WorkerPool::Priority::Low);
+        }
+    }, WorkerPool::Priority::Low);
+}
+
+std::vector<std::string> ScriptPrefetcher::CollectTriggerScripts() {
+    std::unordered_set<std::string, CaseInsensitiveHash, CaseInsensitiveEqual> found;
+    fs::path extensionsPath = GetPluginPath() / "extensions";
+
+    std::error_code ec;
+    if (!fs::is_directory(extensionsPath, ec)) {
+        return {};
+    }
+
+    for (const auto& extEntry : fs::directory_iterator(extensionsPath, ec)) {
+        if (!extEntry.is_directory(ec)) {
+            continue;
+        }
+        for (const auto& trigEntry : fs::directory_iterator(extEntry.path(), ec)) {
+            if (!trigEntry.is_regular_file(ec) || !str::iEquals(trigEntry.path().extension().string(), ".json")) {
+                continue;
+            }
+
+            nlohmann::json j;
+            try {
+                std::ifstream in(trigEntry.path());
+                in >> j;
+            } catch (...) {
+                continue; // skip invalid json
+            }
+
+            // trigger attributes are free-form, so any string value naming an existing script counts
+            std::vector<std::string> values;
+            CollectStrings(j, values);
+            for (const auto& value : values) {
+                if (auto scriptname = ResolveScriptfilename(value)) {
+                    found.insert(std::move(*scriptname));
+                }
+            }
+        }
+    }
+
+    return { found.begin(), found.end() };
+}
+
+std::optional<std::string> ScriptPrefetcher::ResolveScriptfilename(std::string_view name) {
+    if (name.empty() || !SystemUtil::File::IsValidPathComponent(name)) {
+        return std::nullopt;
+    }
+
+    std::error_code ec;
+    if (fs::path(name).has_extension()) {
+        if (fs::is_regular_file(GetScriptfilePath(name), ec)) {
+            return std::string(name);
+        }
+        return std::nullopt;
+    }
+
+    // same precedence as NormalizeScriptfilename
+    for (std::string_view ext : { ".sltscript", ".ini", ".json" }) {
+        std::string candidate = std::string(name) + std::string(ext);
+        if (fs::is_regular_file(GetScriptfilePath(candidate), ec)) {
+            return candidate;
+        }
+    }
+    return std::nullopt;
+}
+
+void ScriptPrefetcher::CollectStrings(const nlohmann::json& node, std::vector<std::string>& out) {
+    if (node.is_string()) {
+        out.push_back(node.get<std::string>());
+    } else if (node.is_structured()) {
+        for (const auto& child : node) {
+            CollectStrings(child, out);
+        }
+    }
+}
+#pragma endregion
+}
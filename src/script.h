@@ -0,0 +1,193 @@
+#pragma once
+
+#include "engine.h"
+
+namespace SLT {
+
+#pragma region LoadedScript
+constexpr std::int32_t NO_SLOT = -1;
+constexpr std::int32_t NO_JUMP = -1;
+
+struct ScriptLine {
+    std::int32_t lineNo;                // 1-based line in the source file
+    std::vector<std::string> tokens;
+    std::vector<std::int32_t> slots;    // per token: the variable slot of a plain $name reference, else NO_SLOT
+    std::vector<const RE::BSFixedString*> literals; // per token: the pooled string if the token is passed on verbatim, else nullptr
+
+    // Precomputed control flow, as indices into LoadedScript::lines:
+    //   goto/gosub/if..[label]  the label or beginsub line
+    //   if/elseif               the next elseif/else/endif, taken when the condition is false
+    //   else                    the matching endif
+    //   while                   the matching endwhile, taken when the condition is false
+    //   endwhile/continue       the matching while
+    //   break                   the matching endwhile
+    //   beginsub                the matching endsub, skipping the body in straight-line execution
+    std::int32_t jumpTarget = NO_JUMP;
+    // if/elseif/else: the matching endif, taken when the previous branch runs into this clause
+    std::int32_t blockEnd = NO_JUMP;
+};
+
+// A script file split, tokenized and with every local variable reference resolved to a slot.
+// Scoped names (anything with a '.', e.g. global.foo) are shared across scripts, so they are
+// left to be resolved by name.
+struct LoadedScript {
+    std::string name;
+    fs::file_time_type lastWriteTime;
+    std::vector<ScriptLine> lines;      // functional (non-empty) lines only
+    std::vector<std::string> slotNames; // slot -> variable name, kept for debugging and persistence
+    std::unordered_map<std::string, std::int32_t, CaseInsensitiveHash, CaseInsensitiveEqual> slotIndex;
+    std::unordered_map<std::string, std::int32_t, CaseInsensitiveHash, CaseInsensitiveEqual> labels;      // [label] -> line index
+    std::unordered_map<std::string, std::int32_t, CaseInsensitiveHash, CaseInsensitiveEqual> subroutines; // beginsub name -> line index
+    std::vector<std::string> diagnostics; // malformed control flow found at load, with source line numbers
+    std::vector<std::string> optimizerNotes; // what the optimizer changed, with source line numbers
+    bool optimized = false;
+
+    std::int32_t SlotCount() const { return static_cast<std::int32_t>(slotNames.size()); }
+    std::int32_t FindSlot(std::string_view varName) const;
+    std::int32_t FindLabel(std::string_view label) const;
+    bool HasErrors() const { return !diagnostics.empty(); }
+};
+#pragma endregion
+
+#pragma region ScriptLibrary
+class ScriptLibrary {
+public:
+    static ScriptLibrary& GetSingleton() {
+        static ScriptLibrary singleton;
+        return singleton;
+    }
+
+    // Returns the cached script as it should be executed: the original unless optimization was
+    // turned on for it. Reloads if the file changed on disk; nullptr if it cannot be read.
+    std::shared_ptr<const LoadedScript> Get(std::string_view scriptfilename);
+
+    // Returns the cached script exactly as tokenized from the file
+    std::shared_ptr<const LoadedScript> GetOriginal(std::string_view scriptfilename);
+
+    void SetOptimizationEnabled(std::string_view scriptfilename, bool enabled);
+    bool IsOptimizationEnabled(std::string_view scriptfilename) const;
+
+    void Invalidate(std::string_view scriptfilename);
+    void Clear();
+
+    // true for plain local names, false for scoped (cross-script) names
+    static bool IsSlottedVariable(std::string_view varName);
+
+    // true for names with a scope prefix (global.foo), which live in the global store
+    static bool IsScopedVariable(std::string_view varName);
+
+    // (Re)computes labels, subroutines, jump targets and diagnostics from the script's lines;
+    // scratch backs the temporary block stack only
+    static void BuildControlFlow(LoadedScript& script, std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+    // (Re)fills each line's literals from the TokenPool
+    static void InternLiterals(LoadedScript& script);
+
+    // Reads and tokenizes a script file and resolves its slots and control flow, without caching
+    // it or interning its literals. Touches no game state, so it also runs outside the game.
+    static std::shared_ptr<LoadedScript> Parse(std::string_view scriptfilename, const fs::path& filepath);
+
+private:
+    struct Entry {
+        std::shared_ptr<const LoadedScript> original;
+        std::shared_ptr<const LoadedScript> optimized;
+    };
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, Entry, CaseInsensitiveHash, CaseInsensitiveEqual> scripts;
+    std::unordered_set<std::string, CaseInsensitiveHash, CaseInsensitiveEqual> optimizationEnabled;
+
+    Entry GetEntry(std::string_view scriptfilename);
+
+    static std::shared_ptr<LoadedScript> Load(std::string_view scriptfilename, const fs::path& filepath);
+
+    ScriptLibrary() = default;
+    ScriptLibrary(const ScriptLibrary&) = delete;
+    ScriptLibrary& operator=(const ScriptLibrary&) = delete;
+};
+#pragma endregion
+
+#pragma region ScriptHandleTable
+constexpr ScriptHandle INVALID_SCRIPT_HANDLE = 0;
+
+// Handles a running Papyrus script holds on a loaded script, so it can fetch one line at a time
+// with typed results instead of receiving the whole script as one string array. A handle pins
+// the script as it was when opened; a reload on disk does not change what the handle sees.
+//
+// Each handle belongs to the active effect running the script and is released when that effect
+// ends, whether or not the script got to close it. Handles are kept in the cosave by script
+// name, so a script that was running when the game was saved keeps its handle across the load;
+// that script is read again from disk the first time the handle is resolved afterwards.
+class ScriptHandleTable : public RE::BSTEventSink<RE::TESActiveEffectApplyRemoveEvent> {
+public:
+    static constexpr std::uint32_t kRecord = 'SHND';
+    static constexpr std::uint32_t kRecordVersion = 1;
+
+    static ScriptHandleTable& GetSingleton() {
+        static ScriptHandleTable singleton;
+        return singleton;
+    }
+
+    // Registers for effect remove events; call once data is loaded
+    void Install();
+
+    // Returns INVALID_SCRIPT_HANDLE if the script cannot be loaded. A handle without an owner
+    // lives until Close.
+    ScriptHandle Open(std::string_view scriptfilename, RE::ActiveEffect* owner);
+    void Close(ScriptHandle handle);
+    std::shared_ptr<const LoadedScript> Resolve(ScriptHandle handle);
+    void Clear();
+
+    // Cosave record, written and read from VariableStore's serialization callbacks
+    void Save(SKSE::SerializationInterface* intfc);
+    void Load(SKSE::SerializationInterface* intfc, std::uint32_t version);
+
+    // After a load: drops handles whose effect did not survive it; main thread only
+    void ValidateOwners();
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event,
+                                          RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>*) override;
+
+private:
+    struct Entry {
+        std::shared_ptr<const LoadedScript> script; // null after a load until first resolved
+        std::string scriptfilename;
+        RE::FormID ownerTarget = 0;
+        std::uint16_t ownerEffectId = 0;
+        bool owned = false;
+    };
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<ScriptHandle, Entry> handles;
+    ScriptHandle nextHandle = 1;
+    std::atomic<std::size_t> ownedCount = 0; // lets effect events skip the lock while nothing is owned
+
+    void RecountOwnedLocked();
+
+    ScriptHandleTable() = default;
+    ScriptHandleTable(const ScriptHandleTable&) = delete;
+    ScriptHandleTable& operator=(const ScriptHandleTable&) = delete;
+};
+#pragma endregion
+
+#pragma region ScriptPrefetcher
+// Warms ScriptLibrary with the scripts named by trigger definitions, so the first firing of a
+// trigger in a session does not pay for the file read and tokenization. All work runs on the
+// WorkerPool at low priority, one job per script.
+class ScriptPrefetcher {
+public:
+    // Queues a scan of extensions/*/*.json; ignored while a previous scan is still queued
+    static void Schedule();
+
+    // Script filenames (with extension) referenced by any trigger file that exist in commands/
+    static std::vector<std::string> CollectTriggerScripts();
+
+    // The filename (with extension) in commands/ that name refers to, with or without its
+    // extension; never throws
+    static std::optional<std::string> ResolveScriptfilename(std::string_view name);
+
+private:
+    static void CollectStrings(const nlohmann::json& node, std::vector<std::string>& out);
+};
+#pragma endregion
+}
@@ -0,0 +1,428 @@
+#include "scriptcontext.h"
+#include "expression.h"
+#include "taskqueue.h"
+#include "variables.h"
+
+namespace SLT {
+
+#pragma region CoroutineFramePool
+std::optional<std::size_t> CoroutineFramePool::SizeClass(std::size_t size) {
+    for (std::size_t bits = kMinClassBits; bits <= kMaxClassBits; ++bits) {
+        if (size <= (std::size_t{ 1 } << bits)) {
+            return bits - kMinClassBits;
+        }
+    }
+    return std::nullopt;
+}
+
+void* CoroutineFramePool::Allocate(std::size_t size) {
+    auto sizeClass = SizeClass(size);
+    if (!sizeClass) {
+        return ::operator new(size);
+    }
+    {
+        std::lock_guard lock(mutex);
+        auto& freeList = freeLists[*sizeClass];
+        if (!freeList.empty()) {
+            void* ptr = freeList.back();
+            freeList.pop_back();
+            return ptr;
+        }
+    }
+    return ::operator new(std::size_t{ 1 } << (*sizeClass + kMinClassBits));
+}
+
+void CoroutineFramePool::Deallocate(void* ptr, std::size_t size) {
+    auto sizeClass = SizeClass(size);
+    if (sizeClass) {
+        std::lock_guard lock(mutex);
+        auto& freeList = freeLists[*sizeClass];
+        if (freeList.size() < kMaxCachedPerClass) {
+            freeList.push_back(ptr);
+            return;
+        }
+    }
+    ::operator delete(ptr);
+}
+
+CoroutineFramePool::~CoroutineFramePool() {
+    for (auto& freeList : freeLists) {
+        for (void* ptr : freeList) {
+            ::operator delete(ptr);
+        }
+    }
+}
+#pragma endregion
+
+#pragma region ScriptTask
+ScriptTask::promise_type::promise_type(ScriptContext& ctx)
+    : context(ctx.handle) {}
+
+void ScriptTask::promise_type::unhandled_exception() {
+    try {
+        throw;
+    } catch (const std::exception& e) {
+        logger::error("ScriptContext {}: unhandled exception: {}", context, e.what());
+    } catch (...) {
+        logger::error("ScriptContext {}: unknown exception", context);
+    }
+}
+
+ScriptTask& ScriptTask::operator=(ScriptTask&& other) noexcept {
+    if (this != &other) {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = std::exchange(other.handle, {});
+    }
+    return *this;
+}
+
+ScriptTask::~ScriptTask() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+void ScriptTask::Resume() {
+    if (handle && !handle.done()) {
+        handle.resume();
+    }
+}
+#pragma endregion
+
+#pragma region Awaitables
+bool DispatchOperation::await_suspend(std::coroutine_handle<>) {
+    ContextHandle handle = ctx.handle;
+    PapyrusVM::ResultCallback callback = [handle](std::string result) {
+        auto& manager = ScriptContextManager::GetSingleton();
+        manager.SetMostRecentResult(handle, std::move(result));
+        manager.Resume(handle);
+    };
+
+    if (!PapyrusVM::Get().HasActiveEffect(ctx.targetId, ctx.effectId)) {
+        // the effect ended while we were suspended; nothing is left to run the operation on
+        logger::debug("ScriptContext {}: effect {} on {:08X} is gone", ctx.handle, ctx.effectId, ctx.targetId);
+        ctx.cancelled = true;
+        dispatched = false;
+        return false;
+    }
+
+    // set before dispatching: once the call is out the callback may resume us on another thread
+    ctx.mostRecentResult.clear();
+    dispatched = true;
+    if (!OperationRunner::RunOperationOnActor(ctx.targetId, ctx.effectId, std::move(params), std::move(callback))) {
+        dispatched = false;
+        return false; // continue immediately with the failure
+    }
+    return true;
+}
+
+void QueuedStart::await_suspend(std::coroutine_handle<>) {
+    ContextHandle handle = ctx.handle;
+    MainThreadQueue::GetSingleton().Enqueue([handle]() { ScriptContextManager::GetSingleton().Resume(handle); });
+}
+
+void WaitFor::await_suspend(std::coroutine_handle<>) {
+    ContextHandle handle = ctx.handle;
+    auto resume = [handle]() { ScriptContextManager::GetSingleton().Resume(handle); };
+    if (clock == WaitScheduler::Clock::GameTime) {
+        WaitScheduler::GetSingleton().ScheduleGameTime(amount, std::move(resume));
+    } else {
+        WaitScheduler::GetSingleton().ScheduleRealTime(amount, std::move(resume));
+    }
+}
+#pragma endregion
+
+#pragma region ScriptContextManager
+namespace {
+bool IsCommand(const ScriptLine& line, std::string_view cmd) {
+    return str::iEquals(line.tokens[0], cmd);
+}
+
+// Resolves one token the way the Papyrus side would before handing it to an operation
+std::string ResolveToken(const ScriptContext& ctx, const ScriptLine& line, std::size_t index) {
+    const std::string& token = line.tokens[index];
+    auto& store = VariableStore::GetSingleton();
+    if (line.slots[index] != NO_SLOT) {
+        return store.GetFrameSlot(ctx.frame, line.slots[index]).value_or("");
+    }
+    if (token.empty() || (token[0] != '$' && token[0] != '"')) {
+        return token;
+    }
+
+    auto bound = ExpressionCache::GetSingleton().GetOrCompileBound(ctx.script, line.lineNo, std::span(&token, 1),
+                                                                   static_cast<std::int32_t>(index));
+    if (!bound.compiled) {
+        return token;
+    }
+    return ExprValueToString(bound.EvaluateInFrame(ctx.frame));
+}
+
+// Operation arguments from line.tokens[first..]; literal tokens are flagged so the VM can reuse
+// the strings pooled for them at load
+std::vector<PapyrusVM::Argument> ResolveArguments(const ScriptContext& ctx, const ScriptLine& line, std::size_t first) {
+    std::vector<PapyrusVM::Argument> resolved;
+    resolved.reserve(line.tokens.size() - first);
+    for (std::size_t i = first; i < line.tokens.size(); ++i) {
+        if (line.literals[i]) {
+            resolved.push_back({ line.tokens[i], true });
+        } else {
+            resolved.push_back({ ResolveToken(ctx, line, i), false });
+        }
+    }
+    return resolved;
+}
+
+bool EvaluateCondition(const ScriptContext& ctx, const ScriptLine& line, std::size_t first, std::size_t last) {
+    std::span tokens(line.tokens.begin() + first, line.tokens.begin() + last);
+    auto bound = ExpressionCache::GetSingleton().GetOrCompileBound(ctx.script, line.lineNo, tokens);
+    return bound.compiled && SmartComparator::Truthy(bound.EvaluateInFrame(ctx.frame));
+}
+
+void Assign(const ScriptContext& ctx, const ScriptLine& line, std::string_view value) {
+    auto& store = VariableStore::GetSingleton();
+    const auto name = std::string_view(line.tokens[1]).substr(1);
+    if (line.slots[1] != NO_SLOT) {
+        store.SetFrameSlot(ctx.frame, line.slots[1], value);
+    } else if (ScriptLibrary::IsScopedVariable(name)) {
+        // shared across scripts, read back by EvaluateInFrame's global fallback
+        store.SetGlobalVar(name, value);
+    } else {
+        store.SetFrameVar(ctx.frame, name, value);
+    }
+}
+}
+
+ScriptTask ScriptContextManager::Run(ScriptContext& ctx) {
+    const auto& lines = ctx.script->lines;
+    const auto count = static_cast<std::int32_t>(lines.size());
+    std::int32_t pc = 0;
+    bool arrivedByJump = false; // distinguishes a false branch landing on elseif/else from a branch running into it
+
+    QueuedStart start{ ctx };
+    co_await start;
+
+    while (pc >= 0 && pc < count && !ctx.cancelled) {
+        const ScriptLine& line = lines[pc];
+        const auto& tokens = line.tokens;
+        std::int32_t next = pc + 1;
+        bool jumped = false;
+
+        if (tokens[0].front() == '[' || IsCommand(line, "endif")) {
+            // labels and block ends are markers only
+        } else if (IsCommand(line, "set") && tokens.size() >= 3 && line.tokens[1].size() > 1) {
+            if (tokens.size() >= 4 && str::iEquals(tokens[2], "resultfrom")) {
+                DispatchOperation operation{ ctx, ResolveArguments(ctx, line, 3) };
+                co_await operation;
+                Assign(ctx, line, ctx.mostRecentResult);
+            } else {
+                std::span expr(tokens.begin() + 2, tokens.end());
+                auto bound = ExpressionCache::GetSingleton().GetOrCompileBound(ctx.script, line.lineNo, expr);
+                Assign(ctx, line, bound.compiled ? ExprValueToString(bound.EvaluateInFrame(ctx.frame)) : ResolveToken(ctx, line, 2));
+            }
+        } else if (IsCommand(line, "goto") || IsCommand(line, "gosub")) {
+            std::int32_t target = line.jumpTarget;
+            if (target == NO_JUMP && tokens.size() > 1) {
+                // computed target
+                std::string name = ResolveToken(ctx, line, 1);
+                auto sub = ctx.script->subroutines.find(name);
+                target = IsCommand(line, "gosub") && sub != ctx.script->subroutines.end() ? sub->second : ctx.script->FindLabel(name);
+            }
+            if (target == NO_JUMP) {
+                logger::error("{}({}): {} target not found", ctx.script->name, line.lineNo, tokens[0]);
+                break;
+            }
+            if (IsCommand(line, "gosub")) {
+                ctx.callStack.push_back(pc + 1);
+                next = IsCommand(lines[target], "beginsub") ? target + 1 : target;
+            } else {
+                next = target;
+            }
+        } else if (IsCommand(line, "return") || IsCommand(line, "endsub")) {
+            if (ctx.callStack.empty()) {
+                break;
+            }
+            next = ctx.callStack.back();
+            ctx.callStack.pop_back();
+        } else if (IsCommand(line, "beginsub")) {
+            next = line.jumpTarget + 1; // subroutine bodies only run through gosub
+        } else if (IsCommand(line, "if") && line.blockEnd == NO_JUMP) {
+            if (EvaluateCondition(ctx, line, 1, tokens.size() - 1)) {
+                next = line.jumpTarget;
+            }
+        } else if (IsCommand(line, "if") || IsCommand(line, "elseif")) {
+            if (IsCommand(line, "elseif") && !arrivedByJump) {
+                next = line.blockEnd; // the previous branch ran, skip the rest of the chain
+            } else if (!EvaluateCondition(ctx, line, 1, tokens.size())) {
+                next = line.jumpTarget;
+                jumped = true;
+            }
+        } else if (IsCommand(line, "else")) {
+            if (!arrivedByJump) {
+                next = line.blockEnd;
+            }
+        } else if (IsCommand(line, "while")) {
+            if (!EvaluateCondition(ctx, line, 1, tokens.size())) {
+                next = line.jumpTarget + 1;
+            }
+        } else if (IsCommand(line, "endwhile") || IsCommand(line, "continue")) {
+            next = line.jumpTarget;
+        } else if (IsCommand(line, "break")) {
+            next = line.jumpTarget + 1;
+        } else if (IsCommand(line, "util_wait") || IsCommand(line, "util_waitgametime")) {
+            float amount = tokens.size() > 1 ? Util::String::TryToFloat(ResolveToken(ctx, line, 1)) : 0.0f;
+            auto clock = IsCommand(line, "util_wait") ? WaitScheduler::Clock::RealTime : WaitScheduler::Clock::GameTime;
+            WaitFor wait{ ctx, amount, clock };
+            co_await wait;
+        } else {
+            // awaiters are kept as named locals so their state lives in the coroutine frame
+            DispatchOperation operation{ ctx, ResolveArguments(ctx, line, 0) };
+            if (!co_await operation) {
+                logger::error("{}({}): unable to dispatch '{}'", ctx.script->name, line.lineNo, tokens[0]);
+            }
+        }
+
+        arrivedByJump = jumped;
+        pc = next;
+    }
+
+    VariableStore::GetSingleton().ReleaseFrame(ctx.frame);
+    logger::debug("ScriptContext {}: {} {}", ctx.handle, ctx.script->name, ctx.cancelled ? "cancelled" : "finished");
+}
+
+void ScriptContextManager::Install() {
+    auto* holder = RE::ScriptEventSourceHolder::GetSingleton();
+    if (!holder) {
+        logger::error("ScriptContextManager: event source holder unavailable, contexts only notice a removed effect at their next dispatch");
+        return;
+    }
+    holder->AddEventSink<RE::TESActiveEffectApplyRemoveEvent>(this);
+}
+
+ContextHandle ScriptContextManager::Start(RE::Actor* target, RE::ActiveEffect* cmdPrimary, std::string_view scriptname) {
+    if (!target || !cmdPrimary) {
+        logger::error("ScriptContextManager: not starting {} without a target and effect", scriptname);
+        return 0;
+    }
+    return Start(target->GetFormID(), cmdPrimary->usUniqueID, scriptname);
+}
+
+ContextHandle ScriptContextManager::Start(RE::FormID target, std::uint16_t effectId, std::string_view scriptname) {
+    auto script = ScriptLibrary::GetSingleton().Get(scriptname);
+    if (!script) {
+        logger::error("ScriptContextManager: unable to load script ({})", scriptname);
+        return 0;
+    }
+    return Start(target, effectId, std::move(script));
+}
+
+ContextHandle ScriptContextManager::Start(RE::FormID target, std::uint16_t effectId, std::shared_ptr<const LoadedScript> script) {
+    if (!target || !script) {
+        logger::error("ScriptContextManager: not starting a script without a target or script");
+        return 0;
+    }
+    if (script->HasErrors()) {
+        logger::error("ScriptContextManager: not starting {} ({} control flow errors)", script->name, script->diagnostics.size());
+        return 0;
+    }
+
+    auto ctx = std::make_shared<ScriptContext>();
+    ctx->targetId = target;
+    ctx->effectId = effectId;
+    ctx->script = script;
+    ctx->frame = VariableStore::GetSingleton().AllocateFrame();
+    VariableStore::GetSingleton().BindFrame(ctx->frame, script->slotNames);
+
+    {
+        std::lock_guard lock(mutex);
+        ctx->handle = nextHandle++;
+        if (nextHandle <= 0) {
+            nextHandle = 1;
+        }
+        contexts.emplace(ctx->handle, ctx);
+    }
+
+    ctx->task = Run(*ctx);
+    ContextHandle handle = ctx->handle;
+    ctx->task.Resume();
+    return handle;
+}
+
+void ScriptContextManager::Cancel(ContextHandle handle) {
+    std::lock_guard lock(mutex);
+    auto it = contexts.find(handle);
+    if (it != contexts.end()) {
+        // takes effect the next time the context resumes
+        it->second->cancelled = true;
+    }
+}
+
+bool ScriptContextManager::IsRunning(ContextHandle handle) const {
+    std::lock_guard lock(mutex);
+    return contexts.contains(handle);
+}
+
+std::size_t ScriptContextManager::RunningCount() const {
+    std::lock_guard lock(mutex);
+    return contexts.size();
+}
+
+void ScriptContextManager::SetMostRecentResult(ContextHandle handle, std::string result) {
+    std::lock_guard lock(mutex);
+    auto it = contexts.find(handle);
+    if (it != contexts.end()) {
+        it->second->mostRecentResult = std::move(result);
+    }
+}
+
+void ScriptContextManager::Resume(ContextHandle handle) {
+    std::shared_ptr<ScriptContext> ctx;
+    {
+        std::lock_guard lock(mutex);
+        auto it = contexts.find(handle);
+        if (it == contexts.end()) {
+            return;
+        }
+        ctx = it->second;
+    }
+    // the local reference keeps the frame alive even if the coroutine retires itself
+    ctx->task.Resume();
+}
+
+void ScriptContextManager::Retire(ContextHandle handle) {
+    std::lock_guard lock(mutex);
+    contexts.erase(handle);
+}
+
+void ScriptContextManager::Clear() {
+    std::unordered_map<ContextHandle, std::shared_ptr<ScriptContext>> dropped;
+    {
+        std::lock_guard lock(mutex);
+        dropped.swap(contexts);
+    }
+    if (!dropped.empty()) {
+        logger::info("ScriptContextManager: dropping {} script contexts from the previous session", dropped.size());
+    }
+}
+
+RE::BSEventNotifyControl ScriptContextManager::ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event,
+                                                            RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>*) {
+    if (!a_event || a_event->isApplied || !a_event->target) {
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    const auto target = a_event->target->GetFormID();
+    const auto effectId = a_event->activeEffectUniqueID;
+
+    std::lock_guard lock(mutex);
+    for (auto& [handle, ctx] : contexts) {
+        if (ctx->targetId == target && ctx->effectId == effectId) {
+            // takes effect the next time the context resumes, as with Cancel
+            ctx->cancelled = true;
+        }
+    }
+    return RE::BSEventNotifyControl::kContinue;
+}
+#pragma endregion
+}
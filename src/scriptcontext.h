@@ -0,0 +1,190 @@
+#pragma once
+
+#include "script.h"
+#include "scheduler.h"
+
+namespace SLT {
+
+#pragma region CoroutineFramePool
+// Recycles coroutine frames by power-of-two size class so starting and finishing script
+// contexts does not go through the general heap each time. Frames larger than the biggest
+// class fall back to ::operator new.
+class CoroutineFramePool {
+public:
+    static constexpr std::size_t kMinClassBits = 7;  // 128 bytes
+    static constexpr std::size_t kMaxClassBits = 13; // 8 KiB
+    static constexpr std::size_t kMaxCachedPerClass = 256;
+
+    static CoroutineFramePool& GetSingleton() {
+        static CoroutineFramePool singleton;
+        return singleton;
+    }
+
+    void* Allocate(std::size_t size);
+    void Deallocate(void* ptr, std::size_t size);
+
+private:
+    static constexpr std::size_t kClassCount = kMaxClassBits - kMinClassBits + 1;
+
+    std::mutex mutex;
+    std::array<std::vector<void*>, kClassCount> freeLists;
+
+    static std::optional<std::size_t> SizeClass(std::size_t size);
+
+    CoroutineFramePool() = default;
+    ~CoroutineFramePool();
+    CoroutineFramePool(const CoroutineFramePool&) = delete;
+    CoroutineFramePool& operator=(const CoroutineFramePool&) = delete;
+};
+#pragma endregion
+
+#pragma region ScriptTask
+struct ScriptContext;
+
+// Coroutine type of a running script. Starts suspended; the owning ScriptContext resumes it.
+// On completion it retires its context from ScriptContextManager.
+class ScriptTask {
+public:
+    struct promise_type {
+        ContextHandle context;
+
+        promise_type(ScriptContext& ctx);
+
+        ScriptTask get_return_object() { return ScriptTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept;
+        void return_void() {}
+        void unhandled_exception();
+
+        static void* operator new(std::size_t size) { return CoroutineFramePool::GetSingleton().Allocate(size); }
+        static void operator delete(void* ptr, std::size_t size) { CoroutineFramePool::GetSingleton().Deallocate(ptr, size); }
+    };
+
+    ScriptTask() = default;
+    ScriptTask(ScriptTask&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    ScriptTask& operator=(ScriptTask&& other) noexcept;
+    ~ScriptTask();
+
+    void Resume();
+    bool Done() const { return !handle || handle.done(); }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+    explicit ScriptTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+};
+#pragma endregion
+
+#pragma region ScriptContext
+// One natively executed instance of an SLT script. Control flow, set and expressions run
+// in native code; every other command is dispatched to its function library, suspending the
+// coroutine until the VM reports the call finished, so no VM stack is held in between.
+//
+// The effect running the script is kept by id, not by pointer: it can end while the context is
+// suspended, so it is looked up again before each dispatch.
+struct ScriptContext {
+    ContextHandle handle = 0;
+    RE::FormID targetId = 0;
+    std::uint16_t effectId = 0;
+    std::shared_ptr<const LoadedScript> script;
+    FrameHandle frame = 0;
+    std::vector<std::int32_t> callStack; // gosub return line indices
+    std::string mostRecentResult;        // return value of the last dispatched operation
+    std::atomic<bool> cancelled = false;
+    ScriptTask task;
+};
+#pragma endregion
+
+#pragma region Awaitables
+// co_await: runs a function-library operation, resuming with false if it could not be dispatched
+struct DispatchOperation {
+    ScriptContext& ctx;
+    std::vector<PapyrusVM::Argument> params; // moved into the call
+    bool dispatched = false;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<>);
+    bool await_resume() const noexcept { return dispatched; }
+};
+
+// co_await: parks a newly started context until the MainThreadQueue picks it up, so the native
+// that started it returns without running any of the script on its VM stack
+struct QueuedStart {
+    ScriptContext& ctx;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>);
+    void await_resume() const noexcept {}
+};
+
+// co_await: parks the context in the WaitScheduler for the given time
+struct WaitFor {
+    ScriptContext& ctx;
+    float amount;
+    WaitScheduler::Clock clock = WaitScheduler::Clock::RealTime;
+
+    bool await_ready() const noexcept { return amount <= 0.0f; }
+    void await_suspend(std::coroutine_handle<>);
+    void await_resume() const noexcept {}
+};
+#pragma endregion
+
+#pragma region ScriptContextManager
+// Owns the running contexts. A context is cancelled when the effect it runs under is removed.
+class ScriptContextManager : public RE::BSTEventSink<RE::TESActiveEffectApplyRemoveEvent> {
+public:
+    static ScriptContextManager& GetSingleton() {
+        static ScriptContextManager singleton;
+        return singleton;
+    }
+
+    // Registers for effect remove events; call once data is loaded
+    void Install();
+
+    // Loads the script and queues it to run on the main thread; returns 0 if it could not start.
+    // effectId is the unique id of the active effect on target the script runs under.
+    ContextHandle Start(RE::FormID target, std::uint16_t effectId, std::string_view scriptname);
+    ContextHandle Start(RE::Actor* target, RE::ActiveEffect* cmdPrimary, std::string_view scriptname);
+
+    // As above, for a script that is already loaded
+    ContextHandle Start(RE::FormID target, std::uint16_t effectId, std::shared_ptr<const LoadedScript> script);
+    void Cancel(ContextHandle handle);
+    bool IsRunning(ContextHandle handle) const;
+    std::size_t RunningCount() const;
+
+    // Resumes a suspended context; ignored if it has since finished or been cleared
+    void Resume(ContextHandle handle);
+    void SetMostRecentResult(ContextHandle handle, std::string result);
+
+    // Called by a finishing coroutine from its final suspension point
+    void Retire(ContextHandle handle);
+
+    // Drops every context, e.g. when a game is loaded and their VM calls will never return
+    void Clear();
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event,
+                                          RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>*) override;
+
+private:
+    mutable std::mutex mutex;
+    std::unordered_map<ContextHandle, std::shared_ptr<ScriptContext>> contexts;
+    ContextHandle nextHandle = 1;
+
+    static ScriptTask Run(ScriptContext& ctx);
+
+    ScriptContextManager() = default;
+    ScriptContextManager(const ScriptContextManager&) = delete;
+    ScriptContextManager& operator=(const ScriptContextManager&) = delete;
+};
+#pragma endregion
+
+inline auto ScriptTask::promise_type::final_suspend() noexcept {
+    struct Retire {
+        ContextHandle context;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<>) const noexcept { ScriptContextManager::GetSingleton().Retire(context); }
+        void await_resume() const noexcept {}
+    };
+    return Retire{ context };
+}
+}
@@ -1,5 +1,12 @@
 #include "engine.h"
+#include "eventfilter.h"
+#include "keymap.h"
+#include "scheduler.h"
+#include "script.h"
+#include "scriptcontext.h"
 #include "sl_triggers.h"
+#include "triggergate.h"
+#include "variables.h"
 
 namespace SLT {
 
@@ -17,6 +24,9 @@ namespace SLT {
         // Register the provider
         REGISTER_PAPYRUS_PROVIDER(SLTPapyrusFunctionProvider, "sl_triggers");
         REGISTER_PAPYRUS_PROVIDER(SLTInternalPapyrusFunctionProvider, "sl_triggers_internal");
+
+        VariableStore::GetSingleton().RegisterSerialization();
+        WaitScheduler::Install();
     }
 
     void GameEventHandler::onPostLoad() {
@@ -28,26 +38,50 @@ namespace SLT {
     }
 
     void GameEventHandler::onInputLoaded() {
-        //logger::info("onInputLoaded()");
+        KeyChordSink::GetSingleton().Install();
     }
 
     void GameEventHandler::onDataLoaded() {
         FunctionLibrary::PrecacheLibraries();
         ScriptPoolManager::GetSingleton().InitializePool();
+        NifUtil::ActorNodeCache::GetSingleton().Install();
+        GameEventFilter::GetSingleton().Install();
+        TriggerGate::GetSingleton().Install();
+        ScriptHandleTable::GetSingleton().Install();
+        ScriptContextManager::GetSingleton().Install();
+        ScriptPrefetcher::Schedule();
     }
 
     void GameEventHandler::onNewGame() {
+        WaitScheduler::GetSingleton().Clear();
+        ScriptContextManager::GetSingleton().Clear();
+        NifUtil::ActorNodeCache::GetSingleton().Clear();
+        KeyChordSink::GetSingleton().Clear();
+        GameEventFilter::GetSingleton().Clear();
+        ScriptHandleTable::GetSingleton().Clear();
         SLT::GenerateNewSessionId(true);
+        TriggerGate::GetSingleton().Clear();
+        TriggerGate::GetSingleton().Reseed(SLT::GetSessionId());
         logger::info("{} starting session {}", SystemUtil::File::GetPluginName(), SLT::GetSessionId());
     }
 
     void GameEventHandler::onPreLoadGame() {
-        //logger::info("onPreLoadGame()");
+        WaitScheduler::GetSingleton().Clear();
+        ScriptContextManager::GetSingleton().Clear();
+        NifUtil::ActorNodeCache::GetSingleton().Clear();
+        KeyChordSink::GetSingleton().Clear();
+        GameEventFilter::GetSingleton().Clear();
     }
 
     void GameEventHandler::onPostLoadGame() {
         SLT::GenerateNewSessionId(true);
+        // cooldowns and running markers came back with the cosave; only the rolls start over
+        TriggerGate::GetSingleton().Reseed(SLT::GetSessionId());
+        TriggerGate::GetSingleton().ValidateRunning();
+        // handles of scripts that were running when the game was saved came back with the cosave
+        ScriptHandleTable::GetSingleton().ValidateOwners();
         logger::info("{} starting session {}", SystemUtil::File::GetPluginName(), SLT::GetSessionId());
+        ScriptPrefetcher::Schedule();
     }
 
     void GameEventHandler::onSaveGame() {
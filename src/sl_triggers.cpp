@@ -1,5 +1,15 @@
 #include "engine.h"
+#include "eventfilter.h"
+#include "expression.h"
+#include "keymap.h"
+#include "scheduler.h"
+#include "script.h"
+#include "scriptcontext.h"
 #include "sl_triggers.h"
+#include "taskqueue.h"
+#include "triggergate.h"
+#include "variables.h"
+#include "workerpool.h"
 
 #pragma push(warning)
 #pragma warning(disable:4100)
@@ -12,6 +22,49 @@ namespace SLT {
 #pragma region SLTNativeFunctions definition
 
 // Non-latent Functions
+FrameHandle SLTNativeFunctions::AllocateVariableFrame(PAPYRUS_NATIVE_DECL) {
+    return VariableStore::GetSingleton().AllocateFrame();
+}
+
+std::int32_t SLTNativeFunctions::BindVariableFrame(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view scriptname) {
+    auto script = ScriptLibrary::GetSingleton().Get(scriptname);
+    if (!script) {
+        logger::error("BindVariableFrame: unable to load script ({})", scriptname);
+        return -1;
+    }
+    return VariableStore::GetSingleton().BindFrame(frameHandle, script->slotNames);
+}
+
+void SLTNativeFunctions::CancelScriptContext(PAPYRUS_NATIVE_DECL, ContextHandle contextHandle) {
+    ScriptContextManager::GetSingleton().Cancel(contextHandle);
+}
+
+void SLTNativeFunctions::ClearEventFilters(PAPYRUS_NATIVE_DECL) {
+    GameEventFilter::GetSingleton().Clear();
+}
+
+void SLTNativeFunctions::ClearKeyChords(PAPYRUS_NATIVE_DECL) {
+    KeyChordSink::GetSingleton().Clear();
+}
+
+/**
+; returns int
+;  1 : pass; the cooldown starts now and, if exclusive, the trigger counts as running on target
+;      until ReleaseTriggerGate or until the script effect started for it ends
+;  0 : chance roll failed
+; -1 : on cooldown for this target
+; -2 : exclusive and already running on this target
+; target may be None to gate the trigger globally
+ */
+std::int32_t SLTNativeFunctions::CheckTriggerGate(PAPYRUS_NATIVE_DECL, std::string_view triggerKey, RE::Actor* target, float cooldownSeconds,
+    float chance, bool exclusive) {
+    return TriggerGate::GetSingleton().Check(triggerKey, target ? target->GetFormID() : 0, cooldownSeconds, chance, exclusive);
+}
+
+void SLTNativeFunctions::CloseScriptHandle(PAPYRUS_NATIVE_DECL, ScriptHandle scriptHandle) {
+    ScriptHandleTable::GetSingleton().Close(scriptHandle);
+}
+
 bool SLTNativeFunctions::DeleteTrigger(PAPYRUS_NATIVE_DECL, std::string_view extKeyStr, std::string_view trigKeyStr) {
     if (!SystemUtil::File::IsValidPathComponent(extKeyStr) || !SystemUtil::File::IsValidPathComponent(trigKeyStr)) {
         logger::error("Invalid characters in extensionKey ({}) or triggerKey ({})", extKeyStr, trigKeyStr);
@@ -46,10 +99,71 @@ bool SLTNativeFunctions::DeleteTrigger(PAPYRUS_NATIVE_DECL, std::string_view ext
     }
 }
 
+/**
+; latent: DeleteTrigger on a worker thread
+ */
+RE::BSScript::LatentStatus SLTNativeFunctions::DeleteTriggerLatent(PAPYRUS_NATIVE_DECL, std::string_view extKeyStr, std::string_view trigKeyStr) {
+    return ReturnLatentFromWorker(vm, stackId, [extKey = std::string(extKeyStr), trigKey = std::string(trigKeyStr)]() {
+        return DeleteTrigger(nullptr, 0, extKey, trigKey);
+    });
+}
+
+std::string SLTNativeFunctions::EvaluateExpression(PAPYRUS_NATIVE_DECL, std::string_view scriptname, std::int32_t lineno,
+    std::vector<std::string> tokens, std::vector<std::string> varNames, std::vector<std::string> varValues) {
+    auto compiled = ExpressionCache::GetSingleton().GetOrCompile(scriptname, lineno, tokens);
+    if (!compiled) {
+        return "";
+    }
+
+    if (varNames.size() != varValues.size()) {
+        logger::warn("EvaluateExpression: {}({}) given {} variable names but {} values", scriptname, lineno, varNames.size(), varValues.size());
+    }
+
+    ExprValue result = compiled->Evaluate([&varNames, &varValues](std::string_view name) -> ExprValue {
+        for (std::size_t i = 0; i < varNames.size() && i < varValues.size(); ++i) {
+            std::string_view candidate = varNames[i];
+            if (candidate.starts_with('$')) {
+                candidate.remove_prefix(1);
+            }
+            if (str::iEquals(candidate, name)) {
+                return ExprValueFromText(varValues[i]);
+            }
+        }
+        return ExprValue{};
+    });
+
+    return ExprValueToString(result);
+}
+
+std::string SLTNativeFunctions::EvaluateExpressionInFrame(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view scriptname,
+    std::int32_t lineno, std::vector<std::string> tokens) {
+    auto script = ScriptLibrary::GetSingleton().Get(scriptname);
+    if (!script) {
+        logger::error("EvaluateExpressionInFrame: unable to load script ({})", scriptname);
+        return "";
+    }
+
+    auto bound = ExpressionCache::GetSingleton().GetOrCompileBound(script, lineno, tokens);
+    if (!bound.compiled) {
+        return "";
+    }
+
+    // The frame is expected to be bound to this script, so slots line up with its layout
+    return ExprValueToString(bound.EvaluateInFrame(frameHandle));
+}
+
 void FuzPlay(PAPYRUS_NATIVE_DECL, std::string_view fuzFileName) {
 
 }
 
+std::string SLTNativeFunctions::GetFrameSlot(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::int32_t slot, std::string_view missing) {
+    return VariableStore::GetSingleton().GetFrameSlot(frameHandle, slot).value_or(std::string(missing));
+}
+
+std::string SLTNativeFunctions::GetFrameVar(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view name, std::string_view missing) {
+    return VariableStore::GetSingleton().GetFrameVar(frameHandle, name).value_or(std::string(missing));
+}
+
 RE::TESForm* SLTNativeFunctions::GetForm(PAPYRUS_NATIVE_DECL, std::string_view a_editorID) {
     return FormUtil::Parse::GetForm(a_editorID);
 }
@@ -82,20 +196,197 @@ std::string SLTNativeFunctions::GetNumericLiteral(PAPYRUS_NATIVE_DECL, std::stri
     return "invalid";
 }
 
+/**
+; returns int[12]: events seen, mod events forwarded, then matches merged into a coalescing
+; window, each for hit, combat, equip, container
+ */
+std::vector<std::int32_t> SLTNativeFunctions::GetEventFilterStats(PAPYRUS_NATIVE_DECL) {
+    auto stats = GameEventFilter::GetSingleton().GetStats();
+    std::vector<std::int32_t> result;
+    result.reserve(GameEventFilter::kKindCount * 3);
+    for (const auto* counts : { &stats.seen, &stats.forwarded, &stats.merged }) {
+        for (auto value : *counts) {
+            result.push_back(static_cast<std::int32_t>(std::min<std::uint64_t>(value, std::numeric_limits<std::int32_t>::max())));
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> SLTNativeFunctions::GetExpressionVariables(PAPYRUS_NATIVE_DECL, std::string_view scriptname, std::int32_t lineno,
+    std::vector<std::string> tokens) {
+    std::vector<std::string> result;
+    auto compiled = ExpressionCache::GetSingleton().GetOrCompile(scriptname, lineno, tokens);
+    if (compiled) {
+        for (const auto& name : compiled->GetVariableNames()) {
+            result.push_back("$" + name);
+        }
+    }
+    return result;
+}
+
+/**
+; returns Actor[], nearest first, at most maxCount (capped at 128; <= 0 means 128)
+; keyword/faction/race: None to skip that test
+; flags: 1 = alive only, 2 = in combat only, 4 = exclude center itself
+ */
+std::vector<RE::Actor*> SLTNativeFunctions::FindActorsInRadius(PAPYRUS_NATIVE_DECL, RE::TESObjectREFR* center, float radius, RE::BGSKeyword* keyword,
+    RE::TESFaction* faction, RE::TESRace* race, std::int32_t flags, std::int32_t maxCount) {
+    constexpr std::int32_t kPapyrusArrayLimit = 128;
+    if (!center) {
+        return {};
+    }
+
+    ObjectUtil::Scan::ActorFilter filter;
+    filter.keyword = keyword;
+    filter.faction = faction;
+    filter.race = race;
+    filter.aliveOnly = (flags & 1) != 0;
+    filter.inCombatOnly = (flags & 2) != 0;
+    filter.exclude = (flags & 4) != 0 ? center->As<RE::Actor>() : nullptr;
+
+    auto limit = (maxCount <= 0 || maxCount > kPapyrusArrayLimit) ? kPapyrusArrayLimit : maxCount;
+    return ObjectUtil::Scan::FindActorsInRadius(center->GetPosition(), radius, filter, static_cast<std::size_t>(limit));
+}
+
+/**
+; returns float[], 3 per target in the order given
+; 0 : heading angle from 'from' to the target, degrees
+; 1 : pitch angle from 'from' to the target, degrees
+; 2 : distance; -1 with angles 0 for a None target (or when 'from' is None)
+ */
+std::vector<float> SLTNativeFunctions::GetAnglesAndDistances(PAPYRUS_NATIVE_DECL, RE::TESObjectREFR* from, std::vector<RE::TESObjectREFR*> targets) {
+    std::vector<float> result(targets.size() * 3, 0.0f);
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        result[i * 3 + 2] = -1.0f;
+    }
+    if (!from) {
+        return result;
+    }
+
+    MathUtil::Batch::Points points;
+    std::vector<std::size_t> indices;
+    points.reserve(targets.size());
+    indices.reserve(targets.size());
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        if (targets[i]) {
+            points.push_back(targets[i]->GetPosition());
+            indices.push_back(i);
+        }
+    }
+
+    std::vector<float> angleZ(points.size());
+    std::vector<float> angleX(points.size());
+    std::vector<float> distance(points.size());
+    MathUtil::Batch::GetAngles(from->GetPosition(), points, angleZ, angleX, distance);
+
+    for (std::size_t j = 0; j < indices.size(); ++j) {
+        auto* out = &result[indices[j] * 3];
+        out[0] = MathUtil::Angle::RadianToDegree(angleZ[j]);
+        out[1] = MathUtil::Angle::RadianToDegree(angleX[j]);
+        out[2] = distance[j];
+    }
+    return result;
+}
+
+std::string SLTNativeFunctions::GetGlobalVar(PAPYRUS_NATIVE_DECL, std::string_view name, std::string_view missing) {
+    return VariableStore::GetSingleton().GetGlobalVar(name).value_or(std::string(missing));
+}
+
+std::vector<std::string> SLTNativeFunctions::GetScriptDiagnostics(PAPYRUS_NATIVE_DECL, std::string_view scriptname) {
+    auto script = ScriptLibrary::GetSingleton().Get(scriptname);
+    if (!script) {
+        return {};
+    }
+    return script->diagnostics;
+}
+
+std::vector<std::string> SLTNativeFunctions::GetScriptOptimizerNotes(PAPYRUS_NATIVE_DECL, std::string_view scriptname) {
+    auto script = ScriptLibrary::GetSingleton().Get(scriptname);
+    if (!script) {
+        return {};
+    }
+    return script->optimizerNotes;
+}
+
+/**
+; returns int[], indexed like the functional lines of SplitScriptContentsAndTokenize
+; N-cmdLines : jump target line index for each line (-1 if none)
+; N-cmdLines : enclosing endif line index for each if/elseif/else (-1 if none)
+ */
+std::vector<std::int32_t> SLTNativeFunctions::GetScriptJumpTable(PAPYRUS_NATIVE_DECL, std::string_view scriptname) {
+    std::vector<std::int32_t> result;
+    auto script = ScriptLibrary::GetSingleton().Get(scriptname);
+    if (!script) {
+        return result;
+    }
+
+    result.reserve(script->lines.size() * 2);
+    for (const auto& line : script->lines) {
+        result.push_back(line.jumpTarget);
+    }
+    for (const auto& line : script->lines) {
+        result.push_back(line.blockEnd);
+    }
+    return result;
+}
+
+std::int32_t SLTNativeFunctions::GetScriptLabelIndex(PAPYRUS_NATIVE_DECL, std::string_view scriptname, std::string_view label) {
+    auto script = ScriptLibrary::GetSingleton().Get(scriptname);
+    if (!script) {
+        return NO_JUMP;
+    }
+    return script->FindLabel(label);
+}
+
+/**
+; returns the number of functional lines, or -1 for a closed or invalid handle
+ */
+std::int32_t SLTNativeFunctions::GetScriptLineCount(PAPYRUS_NATIVE_DECL, ScriptHandle scriptHandle) {
+    auto script = ScriptHandleTable::GetSingleton().Resolve(scriptHandle);
+    return script ? static_cast<std::int32_t>(script->lines.size()) : -1;
+}
+
+/**
+; returns the 1-based source file line of functional line lineIndex (0-based), or -1
+ */
+std::int32_t SLTNativeFunctions::GetScriptLineNumber(PAPYRUS_NATIVE_DECL, ScriptHandle scriptHandle, std::int32_t lineIndex) {
+    auto script = ScriptHandleTable::GetSingleton().Resolve(scriptHandle);
+    if (!script || lineIndex < 0 || static_cast<std::size_t>(lineIndex) >= script->lines.size()) {
+        return -1;
+    }
+    return script->lines[lineIndex].lineNo;
+}
+
+/**
+; returns the tokens of functional line lineIndex (0-based); empty for an invalid handle or index
+ */
+std::vector<std::string> SLTNativeFunctions::GetScriptLineTokens(PAPYRUS_NATIVE_DECL, ScriptHandle scriptHandle, std::int32_t lineIndex) {
+    auto script = ScriptHandleTable::GetSingleton().Resolve(scriptHandle);
+    if (!script || lineIndex < 0 || static_cast<std::size_t>(lineIndex) >= script->lines.size()) {
+        return {};
+    }
+    return script->lines[lineIndex].tokens;
+}
+
 std::vector<std::string> SLTNativeFunctions::GetScriptsList(PAPYRUS_NATIVE_DECL) {
     std::vector<std::string> result;
 
     fs::path scriptsFolderPath = GetPluginPath() / "commands";
 
-    if (fs::exists(scriptsFolderPath)) {
-        for (const auto& entry : fs::directory_iterator(scriptsFolderPath)) {
-            if (entry.is_regular_file()) {
-                auto scriptname = entry.path().filename().string();
+    std::error_code ec;
+    if (fs::exists(scriptsFolderPath, ec)) {
+        for (fs::directory_iterator it(scriptsFolderPath, ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code entryEc;
+            if (it->is_regular_file(entryEc)) {
+                auto scriptname = it->path().filename().string();
                 if (scriptname.ends_with(".ini") || scriptname.ends_with(".json")) {
                     result.push_back(scriptname);
                 }
             }
         }
+        if (ec) {
+            logger::error("Unable to list scripts folder ({}): {}", scriptsFolderPath.string(), ec.message());
+        }
     } else {
         logger::error("Scripts folder ({}) doesn't exist. You may need to reinstall the mod.", scriptsFolderPath.string());
     }
@@ -107,10 +398,57 @@ std::vector<std::string> SLTNativeFunctions::GetScriptsList(PAPYRUS_NATIVE_DECL)
     return result;
 }
 
+/**
+; latent: GetScriptsList on a worker thread
+ */
+RE::BSScript::LatentStatus SLTNativeFunctions::GetScriptsListLatent(PAPYRUS_NATIVE_DECL) {
+    return ReturnLatentFromWorker(vm, stackId, []() {
+        return GetScriptsList(nullptr, 0);
+    });
+}
+
+std::vector<std::string> SLTNativeFunctions::GetScriptVariableSlots(PAPYRUS_NATIVE_DECL, std::string_view scriptname) {
+    auto script = ScriptLibrary::GetSingleton().Get(scriptname);
+    if (!script) {
+        return {};
+    }
+    return script->slotNames;
+}
+
 SLTSessionId SLTNativeFunctions::GetSessionId(PAPYRUS_NATIVE_DECL) {
     return SLT::GetSessionId();
 }
 
+/**
+; returns int[]
+; 0-2 : queued tasks at high, normal, low priority
+; 3   : peak queue depth
+; 4   : microseconds spent draining in the last drained frame
+; 5   : peak microseconds spent in one frame
+; 6   : per-frame budget in microseconds
+; 7   : frames that carried work over to the next frame
+; 8   : frames that went over budget
+; 9   : tasks run
+ */
+std::vector<std::int32_t> SLTNativeFunctions::GetTaskQueueStats(PAPYRUS_NATIVE_DECL) {
+    auto stats = MainThreadQueue::GetSingleton().GetStats();
+    auto clamp = [](auto value) {
+        return static_cast<std::int32_t>(std::min<std::uint64_t>(value, std::numeric_limits<std::int32_t>::max()));
+    };
+    return {
+        clamp(stats.depth[0]),
+        clamp(stats.depth[1]),
+        clamp(stats.depth[2]),
+        clamp(stats.peakDepth),
+        clamp(stats.lastFrameTime.count()),
+        clamp(stats.peakFrameTime.count()),
+        clamp(stats.budget.count()),
+        clamp(stats.framesCarriedOver),
+        clamp(stats.framesOverBudget),
+        clamp(stats.tasksRun)
+    };
+}
+
 std::string SLTNativeFunctions::GetTopicInfoResponse(PAPYRUS_NATIVE_DECL, RE::TESTopicInfo* topicInfo) {
     if (!topicInfo) {
         logger::error("GetTopicInfoResponses called but topicInfo was null");
@@ -169,14 +507,19 @@ std::vector<std::string> SLTNativeFunctions::GetTriggerKeys(PAPYRUS_NATIVE_DECL,
 
     fs::path triggerFolderPath = GetPluginPath() / "extensions" / extensionKey;
 
-    if (fs::exists(triggerFolderPath)) {
-        for (const auto& entry : fs::directory_iterator(triggerFolderPath)) {
-            if (entry.is_regular_file()) {
-                if (str::iEquals(entry.path().extension().string(), ".json")) {
-                    result.push_back(entry.path().filename().string());
+    std::error_code ec;
+    if (fs::exists(triggerFolderPath, ec)) {
+        for (fs::directory_iterator it(triggerFolderPath, ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code entryEc;
+            if (it->is_regular_file(entryEc)) {
+                if (str::iEquals(it->path().extension().string(), ".json")) {
+                    result.push_back(it->path().filename().string());
                 }
             }
         }
+        if (ec) {
+            logger::error("Unable to list trigger folder ({}): {}", triggerFolderPath.string(), ec.message());
+        }
     } else {
         logger::error("Trigger folder ({}) doesn't exist. You may need to reinstall the mod or at least make sure the folder is created.",
             triggerFolderPath.string());
@@ -189,6 +532,27 @@ std::vector<std::string> SLTNativeFunctions::GetTriggerKeys(PAPYRUS_NATIVE_DECL,
     return result;
 }
 
+/**
+; latent: GetTriggerKeys on a worker thread
+ */
+RE::BSScript::LatentStatus SLTNativeFunctions::GetTriggerKeysLatent(PAPYRUS_NATIVE_DECL, std::string_view extensionKey) {
+    return ReturnLatentFromWorker(vm, stackId, [key = std::string(extensionKey)]() {
+        return GetTriggerKeys(nullptr, 0, key);
+    });
+}
+
+bool SLTNativeFunctions::HasFrameVar(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view name) {
+    return VariableStore::GetSingleton().HasFrameVar(frameHandle, name);
+}
+
+bool SLTNativeFunctions::HasGlobalVar(PAPYRUS_NATIVE_DECL, std::string_view name) {
+    return VariableStore::GetSingleton().HasGlobalVar(name);
+}
+
+bool SLTNativeFunctions::IsScriptContextRunning(PAPYRUS_NATIVE_DECL, ContextHandle contextHandle) {
+    return ScriptContextManager::GetSingleton().IsRunning(contextHandle);
+}
+
 void SLTNativeFunctions::LogDebug(PAPYRUS_NATIVE_DECL, std::string_view logmsg) {
     logger::debug("{}", logmsg);
 }
@@ -205,6 +569,20 @@ void SLTNativeFunctions::LogWarn(PAPYRUS_NATIVE_DECL, std::string_view logmsg) {
     logger::warn("{}", logmsg);
 }
 
+/**
+; latent: returns true when the wait elapses; the stack stays suspended in the VM meanwhile, as in
+; Utility.Wait, and a wait saved with the game is re-armed when that save is loaded
+ */
+RE::BSScript::LatentStatus SLTNativeFunctions::NativeWait(PAPYRUS_NATIVE_DECL, float seconds) {
+    WaitScheduler::GetSingleton().ScheduleLatentReturn(WaitScheduler::Clock::RealTime, seconds, stackId);
+    return RE::BSScript::LatentStatus::kStarted;
+}
+
+RE::BSScript::LatentStatus SLTNativeFunctions::NativeWaitGameTime(PAPYRUS_NATIVE_DECL, float gameHours) {
+    WaitScheduler::GetSingleton().ScheduleLatentReturn(WaitScheduler::Clock::GameTime, gameHours, stackId);
+    return RE::BSScript::LatentStatus::kStarted;
+}
+
 /*
 0 - unrecognized
 1 - is explicitly .json
@@ -215,28 +593,29 @@ void SLTNativeFunctions::LogWarn(PAPYRUS_NATIVE_DECL, std::string_view logmsg) {
 std::int32_t SLTNativeFunctions::NormalizeScriptfilename(PAPYRUS_NATIVE_DECL, std::string_view scriptfilename) {
     fs::path scrpath = GetScriptfilePath(scriptfilename);
     std::string scrfn = "";
+    std::error_code ec;
 
     if (!scrpath.has_extension()) {
         scrfn = std::string(scriptfilename) + ".sltscript";
         scrpath = GetScriptfilePath(scrfn);
-        if (!scrpath.empty() && fs::exists(scrpath)) {
+        if (!scrpath.empty() && fs::exists(scrpath, ec)) {
             return 30;
         }
 
         scrfn = std::string(scriptfilename) + ".ini";
         scrpath = GetScriptfilePath(scrfn);
-        if (!scrpath.empty() && fs::exists(scrpath)) {
+        if (!scrpath.empty() && fs::exists(scrpath, ec)) {
             return 20;
         }
         
         scrfn = std::string(scriptfilename) + ".json";
         scrpath = GetScriptfilePath(scrfn);
-        if (!scrpath.empty() && fs::exists(scrpath)) {
+        if (!scrpath.empty() && fs::exists(scrpath, ec)) {
             return 10;
         }
     } else {
         scrfn = scrpath.extension().string();
-        if (!scrpath.empty() && fs::exists(scrpath)) {
+        if (!scrpath.empty() && fs::exists(scrpath, ec)) {
             if (scrfn == ".sltscript") {
                 return 3;
             }
@@ -252,9 +631,68 @@ std::int32_t SLTNativeFunctions::NormalizeScriptfilename(PAPYRUS_NATIVE_DECL, st
     return 0;
 }
 
+ScriptHandle SLTNativeFunctions::OpenScriptHandle(PAPYRUS_NATIVE_DECL, RE::ActiveEffect* cmdPrimary, std::string_view scriptfilename) {
+    return ScriptHandleTable::GetSingleton().Open(scriptfilename, cmdPrimary);
+}
+
+/**
+; returns the filter id, or 0 if kind is not 1-4 or eventName is empty
+; kind 1 hit, 2 combat state change, 3 equip/unequip, 4 container change
+; matching events send mod event eventName with sender = subject reference, numArg = filter id and
+; strArg = "<other form id>|<form id>|<state>|<item count>|<events>". Per kind:
+;   subject  hit target | combat actor | equipping actor | either container
+;   other    aggressor | combat target | - | the other container
+;   form     weapon/spell source | - | base object | base object
+;   state    required hit flags (power 1, sneak 2, bash 4, blocked 8) | combat state (0 none,
+;            1 combat, 2 searching) | 1 equip, 0 unequip | 1 added to subject, 0 removed
+; None, or a negative state, matches anything. <events> is 1 unless the filter coalesces (see
+; SetEventFilterDelivery). filters are dropped on game load
+ */
+FilterId SLTNativeFunctions::RegisterEventFilter(PAPYRUS_NATIVE_DECL, std::string_view eventName, std::int32_t kind, RE::TESObjectREFR* subject,
+    RE::TESObjectREFR* other, RE::TESForm* form, RE::BGSKeyword* subjectKeyword, std::int32_t state) {
+    GameEventFilter::Criteria criteria{ static_cast<GameEventFilter::Kind>(kind) };
+    criteria.subject = subject ? subject->GetFormID() : 0;
+    criteria.other = other ? other->GetFormID() : 0;
+    criteria.form = form ? form->GetFormID() : 0;
+    criteria.subjectKeyword = subjectKeyword;
+    criteria.state = state;
+    return GameEventFilter::GetSingleton().Register(eventName, criteria, {});
+}
+
+/**
+; returns the chord id, or 0 if a key code is outside 0-281 or eventName is empty
+; when triggerKey goes down while every modifier is held (and, with holdSeconds > 0, once it has
+; been held that long), sends mod event eventName with numArg = chord id. If several chords on the
+; same key are satisfied, only those with the most modifiers fire.
+; chords are dropped on game load; register them again from the load handler
+ */
+ChordId SLTNativeFunctions::RegisterKeyChord(PAPYRUS_NATIVE_DECL, std::string_view eventName, std::int32_t triggerKey,
+    std::vector<std::int32_t> modifiers, float holdSeconds) {
+    return KeyChordSink::GetSingleton().Register(eventName, triggerKey, modifiers, holdSeconds);
+}
+
+void SLTNativeFunctions::ReleaseTriggerGate(PAPYRUS_NATIVE_DECL, std::string_view triggerKey, RE::Actor* target) {
+    TriggerGate::GetSingleton().Release(triggerKey, target ? target->GetFormID() : 0);
+}
+
+void SLTNativeFunctions::ReleaseVariableFrame(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle) {
+    VariableStore::GetSingleton().ReleaseFrame(frameHandle);
+}
+
 bool SLTNativeFunctions::RunOperationOnActor(PAPYRUS_NATIVE_DECL, RE::Actor* cmdTarget, RE::ActiveEffect* cmdPrimary,
     std::vector<std::string> tokens) {
-    return OperationRunner::RunOperationOnActor(cmdTarget, cmdPrimary, tokens);
+    return OperationRunner::RunOperationOnActor(cmdTarget, cmdPrimary, std::move(tokens));
+}
+
+/**
+; returns false if filterId is unknown
+; windowSeconds > 0 coalesces matches per subject: one mod event per window carries the last
+; event's fields and, as <events>, how many matches it stands for. The window closes
+; windowSeconds after its first match, or with debounce once the subject has been quiet that long
+; windowSeconds 0 goes back to forwarding every match
+ */
+bool SLTNativeFunctions::SetEventFilterDelivery(PAPYRUS_NATIVE_DECL, FilterId filterId, float windowSeconds, bool debounce) {
+    return GameEventFilter::GetSingleton().SetDelivery(filterId, GameEventFilter::Delivery{ windowSeconds, debounce });
 }
 
 void SLTNativeFunctions::SetExtensionEnabled(PAPYRUS_NATIVE_DECL, std::string_view extensionKey, bool enabledState) {
@@ -269,29 +707,32 @@ void SLTNativeFunctions::SetExtensionEnabled(PAPYRUS_NATIVE_DECL, std::string_vi
     }
 }
 
-namespace {
-bool isNumeric(std::string_view str, float& outValue) {
-    const char* begin = str.data();
-    const char* end = begin + str.size();
+bool SLTNativeFunctions::SetFrameSlot(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::int32_t slot, std::string_view value) {
+    return VariableStore::GetSingleton().SetFrameSlot(frameHandle, slot, value);
+}
 
-    auto result = std::from_chars(begin, end, outValue);
-    return result.ec == std::errc() && result.ptr == end;
+bool SLTNativeFunctions::SetFrameVar(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view name, std::string_view value) {
+    return VariableStore::GetSingleton().SetFrameVar(frameHandle, name, value);
 }
+
+void SLTNativeFunctions::SetGlobalVar(PAPYRUS_NATIVE_DECL, std::string_view name, std::string_view value) {
+    VariableStore::GetSingleton().SetGlobalVar(name, value);
 }
 
-bool SLTNativeFunctions::SmartEquals(PAPYRUS_NATIVE_DECL, std::string_view a, std::string_view b) {
-    float aNum = 0.0, bNum = 0.0;
-    bool aIsNum = isNumeric(a, aNum);
-    bool bIsNum = isNumeric(b, bNum);
+/**
+; off unless turned on here: scripts run exactly as written, and GetScriptOptimizerNotes is empty
+ */
+void SLTNativeFunctions::SetScriptOptimization(PAPYRUS_NATIVE_DECL, std::string_view scriptname, bool enabled) {
+    ScriptLibrary::GetSingleton().SetOptimizationEnabled(scriptname, enabled);
+}
 
-    bool outcome = false;
-    if (aIsNum && bIsNum) {
-        outcome = (std::fabs(aNum - bNum) < FLT_EPSILON);  // safe float comparison
-    } else {
-        outcome = (a == b);
-    }
+void SLTNativeFunctions::SetTaskFrameBudget(PAPYRUS_NATIVE_DECL, float milliseconds) {
+    auto budget = std::chrono::microseconds(static_cast<std::int64_t>(std::max(0.0f, milliseconds) * 1000.0f));
+    MainThreadQueue::GetSingleton().SetFrameBudget(budget);
+}
 
-    return outcome;
+bool SLTNativeFunctions::SmartEquals(PAPYRUS_NATIVE_DECL, std::string_view a, std::string_view b) {
+    return SmartComparator::Equals(a, b);
 }
 
 /*
@@ -364,62 +805,119 @@ std::vector<std::string> SLTNativeFunctions::SplitScriptContents(PAPYRUS_NATIVE_
 ; N- + : full set of tokens
  */
 std::vector<std::string> SLTNativeFunctions::SplitScriptContentsAndTokenize(PAPYRUS_NATIVE_DECL, std::string_view scriptfilename) {
-    std::vector<std::string> scriptlineno;
-    std::vector<std::string> tokencount;
-    std::vector<std::string> tokenoffsets;
-
-    std::vector<std::string> linetokens;
-    
-    std::vector<std::string> tokenaccumulator;
+    // ScriptLibrary caches the split/tokenized script and reloads it only when the file changes
+    auto script = ScriptLibrary::GetSingleton().Get(scriptfilename);
+    if (!script) {
+        return { "0" };
+    }
+    const auto& lines = script->lines;
 
-    fs::path filepath = GetScriptfilePath(scriptfilename);
-    std::int32_t lineno = 0;
-    std::int32_t tokcount = 0;
-    std::int32_t tokoffset = 0;
+    std::size_t totalTokens = 0;
+    for (const auto& scriptLine : lines) {
+        totalTokens += scriptLine.tokens.size();
+    }
 
-    if (fs::exists(filepath) && fs::is_regular_file(filepath)) {
-        std::ifstream file(filepath);
-        if (file.good()) {
-            std::string line;
-            while (std::getline(file, line)) {
-                lineno++;
+    // sized once and filled section by section; the header fields are small enough for SSO
+    std::vector<std::string> result;
+    result.reserve(1 + 3 * lines.size() + totalTokens);
 
-                line = Util::String::truncateAt(Util::String::trim(line), ';');
+    result.push_back(std::to_string(lines.size()));
+    for (const auto& scriptLine : lines) {
+        result.push_back(std::to_string(scriptLine.lineNo));
+    }
+    for (const auto& scriptLine : lines) {
+        result.push_back(std::to_string(scriptLine.tokens.size()));
+    }
+    std::size_t tokoffset = 0;
+    for (const auto& scriptLine : lines) {
+        result.push_back(std::to_string(tokoffset));
+        tokoffset += scriptLine.tokens.size();
+    }
+    for (const auto& scriptLine : lines) {
+        result.append_range(scriptLine.tokens);
+    }
 
-                linetokens = Tokenizev2(PAPYRUS_FN_PARMS, line);
+    return result;
+}
 
-                if (linetokens.size() < 1) {
-                    continue;
-                }
+/**
+; latent: SplitScriptContentsAndTokenize on a worker thread, same layout
+ */
+RE::BSScript::LatentStatus SLTNativeFunctions::SplitScriptContentsAndTokenizeLatent(PAPYRUS_NATIVE_DECL, std::string_view scriptfilename) {
+    return ReturnLatentFromWorker(vm, stackId, [name = std::string(scriptfilename)]() {
+        return SplitScriptContentsAndTokenize(nullptr, 0, name);
+    });
+}
 
-                tokoffset += tokcount; // accumulate from previous tokcount
-                tokcount = linetokens.size();
+/**
+; latent: SplitScriptContents on a worker thread
+ */
+RE::BSScript::LatentStatus SLTNativeFunctions::SplitScriptContentsLatent(PAPYRUS_NATIVE_DECL, std::string_view scriptfilename) {
+    return ReturnLatentFromWorker(vm, stackId, [name = std::string(scriptfilename)]() {
+        return SplitScriptContents(nullptr, 0, name);
+    });
+}
 
-                scriptlineno.push_back(std::to_string(lineno));
-                tokencount.push_back(std::to_string(tokcount));
-                tokenoffsets.push_back(std::to_string(tokoffset));
+bool SLTNativeFunctions::StartScript(PAPYRUS_NATIVE_DECL, RE::Actor* cmdTarget, std::string_view initialScriptName) {
+    return ScriptPoolManager::GetSingleton().ApplyScript(cmdTarget, initialScriptName);
+}
 
-                tokenaccumulator.append_range(linetokens);
-            }
-        }
+/**
+; returns int[], one code per target in order
+;  1 : a script slot was reserved and the cast queued; it happens on the main thread shortly
+;      after the call, and a cast that then fails is only logged
+;  0 : target was None or cannot take magic effects
+; -1 : no free script slot on the target
+; -2 : script not found or could not be parsed (same for every target)
+ */
+std::vector<std::int32_t> SLTNativeFunctions::StartScriptBatch(PAPYRUS_NATIVE_DECL, std::vector<RE::Actor*> cmdTargets, std::string_view initialScriptName) {
+    // loaded once for the whole batch, so every effect the casts start finds it in ScriptLibrary
+    auto scriptfilename = ScriptPrefetcher::ResolveScriptfilename(initialScriptName);
+    if (!scriptfilename || !ScriptLibrary::GetSingleton().Get(*scriptfilename)) {
+        logger::error("StartScriptBatch: script not found or not loadable: {}", initialScriptName);
+        return std::vector<std::int32_t>(cmdTargets.size(), ScriptPoolManager::kBatchScriptNotFound);
     }
+    return ScriptPoolManager::GetSingleton().ApplyScriptBatch(cmdTargets, initialScriptName);
+}
 
-    std::vector<std::string> result;
-
-    auto sz = 1 + scriptlineno.size() + tokencount.size() + tokenoffsets.size() + tokenaccumulator.size();
-    result.reserve(1 + scriptlineno.size() + tokencount.size() + tokenoffsets.size() + tokenaccumulator.size());
+ContextHandle SLTNativeFunctions::StartScriptContext(PAPYRUS_NATIVE_DECL, RE::Actor* cmdTarget, RE::ActiveEffect* cmdPrimary,
+    std::string_view scriptname) {
+    return ScriptContextManager::GetSingleton().Start(cmdTarget, cmdPrimary, scriptname);
+}
 
-    result.push_back(std::to_string(scriptlineno.size()));
-    result.append_range(scriptlineno);
-    result.append_range(tokencount);
-    result.append_range(tokenoffsets);
-    result.append_range(tokenaccumulator);
+/**
+; queues the change for the main thread and returns false only if no ref was given
+ */
+bool SLTNativeFunctions::ToggleMeshCollisionBatch(PAPYRUS_NATIVE_DECL, std::vector<RE::TESObjectREFR*> refs, bool collisionState) {
+    std::vector<RE::ObjectRefHandle> handles;
+    handles.reserve(refs.size());
+    for (auto* ref : refs) {
+        if (ref) {
+            handles.push_back(ref->GetHandle());
+        }
+    }
+    if (handles.empty()) {
+        return false;
+    }
 
-    return result;
-}
+    MainThreadQueue::GetSingleton().Enqueue([handles = std::move(handles), collisionState]() {
+        // refs may have unloaded since the call; the smart pointers keep the rest alive for the batch
+        std::vector<RE::NiPointer<RE::TESObjectREFR>> alive;
+        std::vector<RE::TESObjectREFR*> batch;
+        alive.reserve(handles.size());
+        batch.reserve(handles.size());
+        for (const auto& handle : handles) {
+            if (auto ref = handle.get()) {
+                batch.push_back(ref.get());
+                alive.push_back(std::move(ref));
+            }
+        }
 
-bool SLTNativeFunctions::StartScript(PAPYRUS_NATIVE_DECL, RE::Actor* cmdTarget, std::string_view initialScriptName) {
-    return ScriptPoolManager::GetSingleton().ApplyScript(cmdTarget, initialScriptName);
+        auto stats = NifUtil::Collision::ToggleMeshCollision(batch, collisionState);
+        logger::debug("ToggleMeshCollisionBatch: {} roots in {} worlds ({} skipped) in {}us",
+            stats.roots, stats.worlds, stats.skipped + (handles.size() - batch.size()), stats.elapsed.count());
+    });
+    return true;
 }
 
 std::vector<std::string> SLTNativeFunctions::Tokenize(PAPYRUS_NATIVE_DECL, std::string_view input) {
@@ -489,8 +987,7 @@ std::vector<std::string> SLTNativeFunctions::Tokenize(PAPYRUS_NATIVE_DECL, std::
     return tokens;
 }
 
-std::vector<std::string> SLTNativeFunctions::Tokenizev2(PAPYRUS_NATIVE_DECL, std::string_view input) {
-    std::vector<std::string> tokens;
+void SLTNativeFunctions::Tokenizev2(std::string_view input, std::pmr::vector<std::string_view>& tokens) {
     size_t pos = 0;
     size_t len = input.length();
     
@@ -528,7 +1025,7 @@ std::vector<std::string> SLTNativeFunctions::Tokenizev2(PAPYRUS_NATIVE_DECL, std
             }
             
             // Add token with $" prefix, including trailing quote
-            tokens.push_back(std::string(input.substr(start, pos - start)));
+            tokens.push_back(input.substr(start, pos - start));
         }
         // Check for " (double-quoted literal) - SECOND PRECEDENCE
         else if (input[pos] == '"') {
@@ -551,7 +1048,7 @@ std::vector<std::string> SLTNativeFunctions::Tokenizev2(PAPYRUS_NATIVE_DECL, std
             }
             
             // Add token with leading and trailing quotes
-            tokens.push_back(std::string(input.substr(start, pos - start)));
+            tokens.push_back(input.substr(start, pos - start));
         }
         // Check for [ (goto label) - THIRD PRECEDENCE
         else if (input[pos] == '[') {
@@ -568,7 +1065,7 @@ std::vector<std::string> SLTNativeFunctions::Tokenizev2(PAPYRUS_NATIVE_DECL, std
             }
             
             // Add token with leading and trailing brackets
-            tokens.push_back(std::string(input.substr(start, pos - start)));
+            tokens.push_back(input.substr(start, pos - start));
         }
         // Bare token - collect until whitespace - LOWEST PRECEDENCE
         else {
@@ -578,11 +1075,15 @@ std::vector<std::string> SLTNativeFunctions::Tokenizev2(PAPYRUS_NATIVE_DECL, std
                 pos++;
             }
             
-            tokens.push_back(std::string(input.substr(start, pos - start)));
+            tokens.push_back(input.substr(start, pos - start));
         }
     }
+}
 
-    return tokens;
+std::vector<std::string> SLTNativeFunctions::Tokenizev2(PAPYRUS_NATIVE_DECL, std::string_view input) {
+    std::pmr::vector<std::string_view> views;
+    Tokenizev2(input, views);
+    return std::vector<std::string>(views.begin(), views.end());
 }
 
 namespace {
@@ -600,8 +1101,8 @@ bool IsValidVariableName(const std::string& name) {
 }
 }
 
-std::vector<std::string> SLTNativeFunctions::TokenizeForVariableSubstitution(PAPYRUS_NATIVE_DECL, std::string_view input) {
-    std::vector<std::string> result;
+std::vector<SubstitutionPiece> SLTNativeFunctions::TokenizeForVariableSubstitution(std::string_view input) {
+    std::vector<SubstitutionPiece> result;
     
     if (input.empty()) {
         return result;
@@ -657,12 +1158,12 @@ std::vector<std::string> SLTNativeFunctions::TokenizeForVariableSubstitution(PAP
             
             // Add current literal if not empty
             if (!currentLiteral.empty()) {
-                result.push_back(currentLiteral);
+                result.push_back({ currentLiteral, false });
                 currentLiteral.clear();
             }
             
-            // Add variable name bare (with $ prefix)
-            result.push_back("$" + varName);
+            // Add variable name bare (without the $ prefix)
+            result.push_back({ std::move(varName), true });
         } else {
             // Invalid or empty variable name, treat braces as literal
             currentLiteral += input.substr(openBrace, closeBrace - openBrace + 1);
@@ -673,16 +1174,72 @@ std::vector<std::string> SLTNativeFunctions::TokenizeForVariableSubstitution(PAP
     
     // Add final literal if not empty
     if (!currentLiteral.empty()) {
-        result.push_back(currentLiteral);
+        result.push_back({ currentLiteral, false });
     }
     
     return result;
 }
 
+std::vector<std::string> SLTNativeFunctions::TokenizeForVariableSubstitution(PAPYRUS_NATIVE_DECL, std::string_view input) {
+    std::vector<std::string> result;
+    for (auto& piece : TokenizeForVariableSubstitution(input)) {
+        // Papyrus callers tell variables by their $ prefix
+        result.push_back(piece.isVariable ? "$" + piece.text : std::move(piece.text));
+    }
+    return result;
+}
+
+/**
+; transforms holds 6 floats per ref: x, y, z, angleX, angleY, angleZ
+; returns the number of refs whose translation was started, or -1 if the arrays do not line up
+ */
+std::int32_t SLTNativeFunctions::TranslateToBatch(PAPYRUS_NATIVE_DECL, std::vector<RE::TESObjectREFR*> refs, std::vector<float> transforms,
+    float speed, float maxRotationSpeed) {
+    if (transforms.size() != refs.size() * 6) {
+        logger::error("TranslateToBatch: expected {} transform values for {} refs, got {}", refs.size() * 6, refs.size(), transforms.size());
+        return -1;
+    }
+    if (!std::isfinite(speed) || !std::isfinite(maxRotationSpeed)) {
+        logger::error("TranslateToBatch: speed ({}) and maxRotationSpeed ({}) must be finite", speed, maxRotationSpeed);
+        return -1;
+    }
+
+    std::vector<ObjectUtil::Transform::TranslateTarget> targets;
+    targets.reserve(refs.size());
+    for (std::size_t i = 0; i < refs.size(); ++i) {
+        const float* t = &transforms[i * 6];
+        if (!refs[i] || !std::all_of(t, t + 6, [](float v) { return std::isfinite(v); })) {
+            continue;
+        }
+        targets.push_back({ refs[i]->GetHandle(), { t[0], t[1], t[2] }, { t[3], t[4], t[5] } });
+    }
+    if (targets.empty()) {
+        return 0;
+    }
+
+    // runs inline: TranslateTo takes the calling stack, which is only valid for the duration of this call
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    auto started = ObjectUtil::Transform::TranslateBatch(vm, stackId, targets, speed, maxRotationSpeed);
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+    logger::debug("TranslateToBatch: started {} of {} translations in {}us", started, targets.size(), elapsed.count());
+    return static_cast<std::int32_t>(started);
+}
+
 std::string SLTNativeFunctions::Trim(PAPYRUS_NATIVE_DECL, std::string_view str) {
     return Util::String::trim(str);
 }
 
+void SLTNativeFunctions::UnregisterEventFilter(PAPYRUS_NATIVE_DECL, FilterId filterId) {
+    GameEventFilter::GetSingleton().Unregister(filterId);
+}
+
+void SLTNativeFunctions::UnregisterKeyChord(PAPYRUS_NATIVE_DECL, ChordId chordId) {
+    KeyChordSink::GetSingleton().Unregister(chordId);
+}
+
 
 #pragma endregion
 
@@ -3,17 +3,83 @@
 namespace SLT {
 
 #pragma region SLTNativeFunctions declaration
+// One piece of an interpolated string; a variable piece holds the bare name, without '$'
+struct SubstitutionPiece {
+    std::string text;
+    bool isVariable;
+};
+
 class SLTNativeFunctions {
 public:
 // Non-latent functions
+static FrameHandle AllocateVariableFrame(PAPYRUS_NATIVE_DECL);
+
+static std::int32_t BindVariableFrame(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view scriptname);
+
+static void CancelScriptContext(PAPYRUS_NATIVE_DECL, ContextHandle contextHandle);
+
+static std::int32_t CheckTriggerGate(PAPYRUS_NATIVE_DECL, std::string_view triggerKey, RE::Actor* target, float cooldownSeconds,
+                                            float chance, bool exclusive);
+
+static void ClearEventFilters(PAPYRUS_NATIVE_DECL);
+
+static void ClearKeyChords(PAPYRUS_NATIVE_DECL);
+
+static void CloseScriptHandle(PAPYRUS_NATIVE_DECL, ScriptHandle scriptHandle);
+
 static bool DeleteTrigger(PAPYRUS_NATIVE_DECL, std::string_view extKeyStr, std::string_view trigKeyStr);
 
+static RE::BSScript::LatentStatus DeleteTriggerLatent(PAPYRUS_NATIVE_DECL, std::string_view extKeyStr, std::string_view trigKeyStr);
+
+static std::string EvaluateExpression(PAPYRUS_NATIVE_DECL, std::string_view scriptname, std::int32_t lineno,
+                                            std::vector<std::string> tokens, std::vector<std::string> varNames,
+                                            std::vector<std::string> varValues);
+
+static std::string EvaluateExpressionInFrame(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view scriptname,
+                                            std::int32_t lineno, std::vector<std::string> tokens);
+
+static std::string GetFrameSlot(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::int32_t slot, std::string_view missing);
+
+static std::string GetFrameVar(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view name, std::string_view missing);
+
+static std::vector<float> GetAnglesAndDistances(PAPYRUS_NATIVE_DECL, RE::TESObjectREFR* from, std::vector<RE::TESObjectREFR*> targets);
+
+static std::vector<std::int32_t> GetEventFilterStats(PAPYRUS_NATIVE_DECL);
+
+static std::vector<std::string> GetExpressionVariables(PAPYRUS_NATIVE_DECL, std::string_view scriptname, std::int32_t lineno,
+                                            std::vector<std::string> tokens);
+
+static std::vector<RE::Actor*> FindActorsInRadius(PAPYRUS_NATIVE_DECL, RE::TESObjectREFR* center, float radius, RE::BGSKeyword* keyword,
+                                            RE::TESFaction* faction, RE::TESRace* race, std::int32_t flags, std::int32_t maxCount);
+
 static RE::TESForm* GetForm(PAPYRUS_NATIVE_DECL, std::string_view a_editorID);
 
 static std::string GetNumericLiteral(PAPYRUS_NATIVE_DECL, std::string_view token);
 
+static std::string GetGlobalVar(PAPYRUS_NATIVE_DECL, std::string_view name, std::string_view missing);
+
+static std::vector<std::int32_t> GetTaskQueueStats(PAPYRUS_NATIVE_DECL);
+
+static std::vector<std::string> GetScriptDiagnostics(PAPYRUS_NATIVE_DECL, std::string_view scriptname);
+
+static std::vector<std::int32_t> GetScriptJumpTable(PAPYRUS_NATIVE_DECL, std::string_view scriptname);
+
+static std::int32_t GetScriptLabelIndex(PAPYRUS_NATIVE_DECL, std::string_view scriptname, std::string_view label);
+
+static std::int32_t GetScriptLineCount(PAPYRUS_NATIVE_DECL, ScriptHandle scriptHandle);
+
+static std::int32_t GetScriptLineNumber(PAPYRUS_NATIVE_DECL, ScriptHandle scriptHandle, std::int32_t lineIndex);
+
+static std::vector<std::string> GetScriptLineTokens(PAPYRUS_NATIVE_DECL, ScriptHandle scriptHandle, std::int32_t lineIndex);
+
+static std::vector<std::string> GetScriptOptimizerNotes(PAPYRUS_NATIVE_DECL, std::string_view scriptname);
+
 static std::vector<std::string> GetScriptsList(PAPYRUS_NATIVE_DECL);
 
+static RE::BSScript::LatentStatus GetScriptsListLatent(PAPYRUS_NATIVE_DECL);
+
+static std::vector<std::string> GetScriptVariableSlots(PAPYRUS_NATIVE_DECL, std::string_view scriptname);
+
 static SLTSessionId GetSessionId(PAPYRUS_NATIVE_DECL);
 
 static std::string GetTopicInfoResponse(PAPYRUS_NATIVE_DECL, RE::TESTopicInfo* topicInfo);
@@ -22,6 +88,14 @@ static std::string GetTranslatedString(PAPYRUS_NATIVE_DECL, std::string_view inp
 
 static std::vector<std::string> GetTriggerKeys(PAPYRUS_NATIVE_DECL, std::string_view extensionKey);
 
+static RE::BSScript::LatentStatus GetTriggerKeysLatent(PAPYRUS_NATIVE_DECL, std::string_view extensionKey);
+
+static bool HasFrameVar(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view name);
+
+static bool HasGlobalVar(PAPYRUS_NATIVE_DECL, std::string_view name);
+
+static bool IsScriptContextRunning(PAPYRUS_NATIVE_DECL, ContextHandle contextHandle);
+
 static void LogDebug(PAPYRUS_NATIVE_DECL, std::string_view logmsg);
 
 static void LogError(PAPYRUS_NATIVE_DECL, std::string_view logmsg);
@@ -30,14 +104,42 @@ static void LogInfo(PAPYRUS_NATIVE_DECL, std::string_view logmsg);
 
 static void LogWarn(PAPYRUS_NATIVE_DECL, std::string_view logmsg);
 
+static RE::BSScript::LatentStatus NativeWait(PAPYRUS_NATIVE_DECL, float seconds);
+
+static RE::BSScript::LatentStatus NativeWaitGameTime(PAPYRUS_NATIVE_DECL, float gameHours);
+
 static std::int32_t NormalizeScriptfilename(PAPYRUS_NATIVE_DECL, std::string_view scriptfilename);
 
+static ScriptHandle OpenScriptHandle(PAPYRUS_NATIVE_DECL, RE::ActiveEffect* cmdPrimary, std::string_view scriptfilename);
+
+static FilterId RegisterEventFilter(PAPYRUS_NATIVE_DECL, std::string_view eventName, std::int32_t kind, RE::TESObjectREFR* subject,
+                                            RE::TESObjectREFR* other, RE::TESForm* form, RE::BGSKeyword* subjectKeyword, std::int32_t state);
+
+static ChordId RegisterKeyChord(PAPYRUS_NATIVE_DECL, std::string_view eventName, std::int32_t triggerKey,
+                                            std::vector<std::int32_t> modifiers, float holdSeconds);
+
+static void ReleaseTriggerGate(PAPYRUS_NATIVE_DECL, std::string_view triggerKey, RE::Actor* target);
+
+static void ReleaseVariableFrame(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle);
+
 static bool RunOperationOnActor(PAPYRUS_NATIVE_DECL, RE::Actor* cmdTarget, RE::ActiveEffect* cmdPrimary,
                                             std::vector<std::string> tokens);
 
+static bool SetEventFilterDelivery(PAPYRUS_NATIVE_DECL, FilterId filterId, float windowSeconds, bool debounce);
+
 static void SetExtensionEnabled(PAPYRUS_NATIVE_DECL, std::string_view extensionKey,
                                             bool enabledState);
 
+static bool SetFrameSlot(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::int32_t slot, std::string_view value);
+
+static bool SetFrameVar(PAPYRUS_NATIVE_DECL, FrameHandle frameHandle, std::string_view name, std::string_view value);
+
+static void SetGlobalVar(PAPYRUS_NATIVE_DECL, std::string_view name, std::string_view value);
+
+static void SetScriptOptimization(PAPYRUS_NATIVE_DECL, std::string_view scriptname, bool enabled);
+
+static void SetTaskFrameBudget(PAPYRUS_NATIVE_DECL, float milliseconds);
+
 static bool SmartEquals(PAPYRUS_NATIVE_DECL, std::string_view a, std::string_view b);
 
 //static std::vector<std::string> SplitFileContents(PAPYRUS_NATIVE_DECL, std::string_view filecontents);
@@ -46,15 +148,39 @@ static std::vector<std::string> SplitScriptContents(PAPYRUS_NATIVE_DECL, std::st
 
 static std::vector<std::string> SplitScriptContentsAndTokenize(PAPYRUS_NATIVE_DECL, std::string_view scriptfilename);
 
+static RE::BSScript::LatentStatus SplitScriptContentsAndTokenizeLatent(PAPYRUS_NATIVE_DECL, std::string_view scriptfilename);
+
+static RE::BSScript::LatentStatus SplitScriptContentsLatent(PAPYRUS_NATIVE_DECL, std::string_view scriptfilename);
+
 static bool StartScript(PAPYRUS_NATIVE_DECL, RE::Actor* cmdTarget, std::string_view initialScriptName);
 
+static std::vector<std::int32_t> StartScriptBatch(PAPYRUS_NATIVE_DECL, std::vector<RE::Actor*> cmdTargets, std::string_view initialScriptName);
+
+static ContextHandle StartScriptContext(PAPYRUS_NATIVE_DECL, RE::Actor* cmdTarget, RE::ActiveEffect* cmdPrimary,
+                                            std::string_view scriptname);
+
+static bool ToggleMeshCollisionBatch(PAPYRUS_NATIVE_DECL, std::vector<RE::TESObjectREFR*> refs, bool collisionState);
+
+static std::int32_t TranslateToBatch(PAPYRUS_NATIVE_DECL, std::vector<RE::TESObjectREFR*> refs, std::vector<float> transforms,
+                                            float speed, float maxRotationSpeed);
+
 static std::string Trim(PAPYRUS_NATIVE_DECL, std::string_view str);
 
+static void UnregisterEventFilter(PAPYRUS_NATIVE_DECL, FilterId filterId);
+
+static void UnregisterKeyChord(PAPYRUS_NATIVE_DECL, ChordId chordId);
+
 static std::vector<std::string> Tokenize(PAPYRUS_NATIVE_DECL, std::string_view input);
 
 static std::vector<std::string> Tokenizev2(PAPYRUS_NATIVE_DECL, std::string_view input);
 
+// Tokenizev2 for the script loader: appends views into input instead of allocating strings
+static void Tokenizev2(std::string_view input, std::pmr::vector<std::string_view>& tokens);
+
 static std::vector<std::string> TokenizeForVariableSubstitution(PAPYRUS_NATIVE_DECL, std::string_view input);
+
+// TokenizeForVariableSubstitution with variables marked, so literal text starting with '$' stays literal
+static std::vector<SubstitutionPiece> TokenizeForVariableSubstitution(std::string_view input);
 };
 #pragma endregion
 
@@ -64,6 +190,30 @@ static std::vector<std::string> TokenizeForVariableSubstitution(PAPYRUS_NATIVE_D
 class SLTPapyrusFunctionProvider : public SLT::binding::PapyrusFunctionProvider<SLTPapyrusFunctionProvider> {
 public:
     // Static Papyrus function implementations
+    static void CloseScriptHandle(PAPYRUS_STATIC_ARGS, std::int32_t scriptHandle) {
+        SLT::SLTNativeFunctions::CloseScriptHandle(PAPYRUS_FN_PARMS, scriptHandle);
+    }
+
+    static std::string EvaluateExpression(PAPYRUS_STATIC_ARGS, std::string_view scriptname, std::int32_t lineno,
+                                            std::vector<std::string> tokens, std::vector<std::string> varNames,
+                                            std::vector<std::string> varValues) {
+        return SLT::SLTNativeFunctions::EvaluateExpression(PAPYRUS_FN_PARMS, scriptname, lineno, tokens, varNames, varValues);
+    }
+
+    static std::vector<RE::Actor*> FindActorsInRadius(PAPYRUS_STATIC_ARGS, RE::TESObjectREFR* center, float radius, RE::BGSKeyword* keyword,
+                                            RE::TESFaction* faction, RE::TESRace* race, std::int32_t flags, std::int32_t maxCount) {
+        return SLT::SLTNativeFunctions::FindActorsInRadius(PAPYRUS_FN_PARMS, center, radius, keyword, faction, race, flags, maxCount);
+    }
+
+    static std::vector<float> GetAnglesAndDistances(PAPYRUS_STATIC_ARGS, RE::TESObjectREFR* from, std::vector<RE::TESObjectREFR*> targets) {
+        return SLT::SLTNativeFunctions::GetAnglesAndDistances(PAPYRUS_FN_PARMS, from, targets);
+    }
+
+    static std::vector<std::string> GetExpressionVariables(PAPYRUS_STATIC_ARGS, std::string_view scriptname, std::int32_t lineno,
+                                            std::vector<std::string> tokens) {
+        return SLT::SLTNativeFunctions::GetExpressionVariables(PAPYRUS_FN_PARMS, scriptname, lineno, tokens);
+    }
+
     static RE::TESForm* GetForm(PAPYRUS_STATIC_ARGS, std::string_view someFormOfFormIdentification) {
         return SLT::SLTNativeFunctions::GetForm(PAPYRUS_FN_PARMS, someFormOfFormIdentification);
     }
@@ -72,10 +222,46 @@ public:
         return SLT::SLTNativeFunctions::GetNumericLiteral(PAPYRUS_FN_PARMS, token);
     }
 
+    static std::vector<std::string> GetScriptDiagnostics(PAPYRUS_STATIC_ARGS, std::string_view scriptname) {
+        return SLT::SLTNativeFunctions::GetScriptDiagnostics(PAPYRUS_FN_PARMS, scriptname);
+    }
+
+    static std::vector<std::int32_t> GetScriptJumpTable(PAPYRUS_STATIC_ARGS, std::string_view scriptname) {
+        return SLT::SLTNativeFunctions::GetScriptJumpTable(PAPYRUS_FN_PARMS, scriptname);
+    }
+
+    static std::int32_t GetScriptLabelIndex(PAPYRUS_STATIC_ARGS, std::string_view scriptname, std::string_view label) {
+        return SLT::SLTNativeFunctions::GetScriptLabelIndex(PAPYRUS_FN_PARMS, scriptname, label);
+    }
+
+    static std::int32_t GetScriptLineCount(PAPYRUS_STATIC_ARGS, std::int32_t scriptHandle) {
+        return SLT::SLTNativeFunctions::GetScriptLineCount(PAPYRUS_FN_PARMS, scriptHandle);
+    }
+
+    static std::int32_t GetScriptLineNumber(PAPYRUS_STATIC_ARGS, std::int32_t scriptHandle, std::int32_t lineIndex) {
+        return SLT::SLTNativeFunctions::GetScriptLineNumber(PAPYRUS_FN_PARMS, scriptHandle, lineIndex);
+    }
+
+    static std::vector<std::string> GetScriptLineTokens(PAPYRUS_STATIC_ARGS, std::int32_t scriptHandle, std::int32_t lineIndex) {
+        return SLT::SLTNativeFunctions::GetScriptLineTokens(PAPYRUS_FN_PARMS, scriptHandle, lineIndex);
+    }
+
+    static std::vector<std::string> GetScriptOptimizerNotes(PAPYRUS_STATIC_ARGS, std::string_view scriptname) {
+        return SLT::SLTNativeFunctions::GetScriptOptimizerNotes(PAPYRUS_FN_PARMS, scriptname);
+    }
+
     static std::vector<std::string> GetScriptsList(PAPYRUS_STATIC_ARGS) {
         return SLT::SLTNativeFunctions::GetScriptsList(PAPYRUS_FN_PARMS);
     }
 
+    static RE::BSScript::LatentStatus GetScriptsListLatent(PAPYRUS_STATIC_ARGS) {
+        return SLT::SLTNativeFunctions::GetScriptsListLatent(PAPYRUS_FN_PARMS);
+    }
+
+    static std::vector<std::string> GetScriptVariableSlots(PAPYRUS_STATIC_ARGS, std::string_view scriptname) {
+        return SLT::SLTNativeFunctions::GetScriptVariableSlots(PAPYRUS_FN_PARMS, scriptname);
+    }
+
     static std::int32_t GetSessionId(PAPYRUS_STATIC_ARGS) {
         return SLT::SLTNativeFunctions::GetSessionId(PAPYRUS_FN_PARMS);
     }
@@ -88,10 +274,26 @@ public:
         return SLT::SLTNativeFunctions::GetTranslatedString(PAPYRUS_FN_PARMS, input);
     }
 
+    static RE::BSScript::LatentStatus NativeWait(PAPYRUS_STATIC_ARGS, float seconds) {
+        return SLT::SLTNativeFunctions::NativeWait(PAPYRUS_FN_PARMS, seconds);
+    }
+
+    static RE::BSScript::LatentStatus NativeWaitGameTime(PAPYRUS_STATIC_ARGS, float gameHours) {
+        return SLT::SLTNativeFunctions::NativeWaitGameTime(PAPYRUS_FN_PARMS, gameHours);
+    }
+
     static std::int32_t NormalizeScriptfilename(PAPYRUS_STATIC_ARGS, std::string_view scriptfilename) {
         return SLT::SLTNativeFunctions::NormalizeScriptfilename(PAPYRUS_FN_PARMS, scriptfilename);
     }
 
+    static std::int32_t OpenScriptHandle(PAPYRUS_STATIC_ARGS, RE::ActiveEffect* cmdPrimary, std::string_view scriptfilename) {
+        return SLT::SLTNativeFunctions::OpenScriptHandle(PAPYRUS_FN_PARMS, cmdPrimary, scriptfilename);
+    }
+
+    static void SetScriptOptimization(PAPYRUS_STATIC_ARGS, std::string_view scriptname, bool enabled) {
+        SLT::SLTNativeFunctions::SetScriptOptimization(PAPYRUS_FN_PARMS, scriptname, enabled);
+    }
+
     static bool SmartEquals(PAPYRUS_STATIC_ARGS, std::string_view a, std::string_view b) {
         return SLT::SLTNativeFunctions::SmartEquals(PAPYRUS_FN_PARMS, a, b);
     }
@@ -104,6 +306,18 @@ public:
         return SLT::SLTNativeFunctions::SplitScriptContentsAndTokenize(PAPYRUS_FN_PARMS, scriptfilename);
     }
 
+    static RE::BSScript::LatentStatus SplitScriptContentsAndTokenizeLatent(PAPYRUS_STATIC_ARGS, std::string_view scriptfilename) {
+        return SLT::SLTNativeFunctions::SplitScriptContentsAndTokenizeLatent(PAPYRUS_FN_PARMS, scriptfilename);
+    }
+
+    static RE::BSScript::LatentStatus SplitScriptContentsLatent(PAPYRUS_STATIC_ARGS, std::string_view scriptfilename) {
+        return SLT::SLTNativeFunctions::SplitScriptContentsLatent(PAPYRUS_FN_PARMS, scriptfilename);
+    }
+
+    static bool ToggleMeshCollisionBatch(PAPYRUS_STATIC_ARGS, std::vector<RE::TESObjectREFR*> refs, bool collisionState) {
+        return SLT::SLTNativeFunctions::ToggleMeshCollisionBatch(PAPYRUS_FN_PARMS, refs, collisionState);
+    }
+
     static std::vector<std::string> Tokenize(PAPYRUS_STATIC_ARGS, std::string_view input) {
         return SLT::SLTNativeFunctions::Tokenize(PAPYRUS_FN_PARMS, input);
     }
@@ -116,27 +330,55 @@ public:
         return SLT::SLTNativeFunctions::TokenizeForVariableSubstitution(PAPYRUS_FN_PARMS, input);
     }
 
+    static std::int32_t TranslateToBatch(PAPYRUS_STATIC_ARGS, std::vector<RE::TESObjectREFR*> refs, std::vector<float> transforms,
+                                            float speed, float maxRotationSpeed) {
+        return SLT::SLTNativeFunctions::TranslateToBatch(PAPYRUS_FN_PARMS, refs, transforms, speed, maxRotationSpeed);
+    }
+
     static std::string Trim(PAPYRUS_STATIC_ARGS, std::string_view str) {
         return SLT::SLTNativeFunctions::Trim(PAPYRUS_FN_PARMS, str);
     }
 
     void RegisterAllFunctions(RE::BSScript::Internal::VirtualMachine* vm, std::string_view className) {
         SLT::binding::PapyrusRegistrar<SLTPapyrusFunctionProvider> reg(vm, className);
+        using SLT::binding::ThreadSafety;
         
+        reg.RegisterStatic<ThreadSafety::PluginState>("CloseScriptHandle", &SLTPapyrusFunctionProvider::CloseScriptHandle);
+        reg.RegisterStatic<ThreadSafety::PluginState>("EvaluateExpression", &SLTPapyrusFunctionProvider::EvaluateExpression);
+        reg.RegisterStatic("FindActorsInRadius", &SLTPapyrusFunctionProvider::FindActorsInRadius);
+        reg.RegisterStatic("GetAnglesAndDistances", &SLTPapyrusFunctionProvider::GetAnglesAndDistances);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetExpressionVariables", &SLTPapyrusFunctionProvider::GetExpressionVariables);
         reg.RegisterStatic("GetForm", &SLTPapyrusFunctionProvider::GetForm);
-        reg.RegisterStatic("GetNumericLiteral", &SLTPapyrusFunctionProvider::GetNumericLiteral);
-        reg.RegisterStatic("GetScriptsList", &SLTPapyrusFunctionProvider::GetScriptsList);
-        reg.RegisterStatic("GetSessionId", &SLTPapyrusFunctionProvider::GetSessionId);
+        reg.RegisterStatic<ThreadSafety::Pure>("GetNumericLiteral", &SLTPapyrusFunctionProvider::GetNumericLiteral);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptDiagnostics", &SLTPapyrusFunctionProvider::GetScriptDiagnostics);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptJumpTable", &SLTPapyrusFunctionProvider::GetScriptJumpTable);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptLabelIndex", &SLTPapyrusFunctionProvider::GetScriptLabelIndex);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptLineCount", &SLTPapyrusFunctionProvider::GetScriptLineCount);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptLineNumber", &SLTPapyrusFunctionProvider::GetScriptLineNumber);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptLineTokens", &SLTPapyrusFunctionProvider::GetScriptLineTokens);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptOptimizerNotes", &SLTPapyrusFunctionProvider::GetScriptOptimizerNotes);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptsList", &SLTPapyrusFunctionProvider::GetScriptsList);
+        reg.RegisterStaticLatent<std::vector<std::string>>("GetScriptsListLatent", &SLTPapyrusFunctionProvider::GetScriptsListLatent);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetScriptVariableSlots", &SLTPapyrusFunctionProvider::GetScriptVariableSlots);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetSessionId", &SLTPapyrusFunctionProvider::GetSessionId);
         reg.RegisterStatic("GetTopicInfoResponse", &SLTPapyrusFunctionProvider::GetTopicInfoResponse);
         reg.RegisterStatic("GetTranslatedString", &SLTPapyrusFunctionProvider::GetTranslatedString);
-        reg.RegisterStatic("NormalizeScriptfilename", &SLTPapyrusFunctionProvider::NormalizeScriptfilename);
-        reg.RegisterStatic("SmartEquals", &SLTPapyrusFunctionProvider::SmartEquals);
-        reg.RegisterStatic("SplitScriptContents", &SLTPapyrusFunctionProvider::SplitScriptContents);
-        reg.RegisterStatic("SplitScriptContentsAndTokenize", &SLTPapyrusFunctionProvider::SplitScriptContentsAndTokenize);
-        reg.RegisterStatic("Tokenize", &SLTPapyrusFunctionProvider::Tokenize);
-        reg.RegisterStatic("Tokenizev2", &SLTPapyrusFunctionProvider::Tokenizev2);
-        reg.RegisterStatic("TokenizeForVariableSubstitution", &SLTPapyrusFunctionProvider::TokenizeForVariableSubstitution);
-        reg.RegisterStatic("Trim", &SLTPapyrusFunctionProvider::Trim);
+        reg.RegisterStaticLatent<bool>("NativeWait", &SLTPapyrusFunctionProvider::NativeWait);
+        reg.RegisterStaticLatent<bool>("NativeWaitGameTime", &SLTPapyrusFunctionProvider::NativeWaitGameTime);
+        reg.RegisterStatic<ThreadSafety::PluginState>("NormalizeScriptfilename", &SLTPapyrusFunctionProvider::NormalizeScriptfilename);
+        reg.RegisterStatic("OpenScriptHandle", &SLTPapyrusFunctionProvider::OpenScriptHandle);
+        reg.RegisterStatic<ThreadSafety::PluginState>("SetScriptOptimization", &SLTPapyrusFunctionProvider::SetScriptOptimization);
+        reg.RegisterStatic<ThreadSafety::Pure>("SmartEquals", &SLTPapyrusFunctionProvider::SmartEquals);
+        reg.RegisterStatic<ThreadSafety::PluginState>("SplitScriptContents", &SLTPapyrusFunctionProvider::SplitScriptContents);
+        reg.RegisterStatic<ThreadSafety::PluginState>("SplitScriptContentsAndTokenize", &SLTPapyrusFunctionProvider::SplitScriptContentsAndTokenize);
+        reg.RegisterStaticLatent<std::vector<std::string>>("SplitScriptContentsAndTokenizeLatent", &SLTPapyrusFunctionProvider::SplitScriptContentsAndTokenizeLatent);
+        reg.RegisterStaticLatent<std::vector<std::string>>("SplitScriptContentsLatent", &SLTPapyrusFunctionProvider::SplitScriptContentsLatent);
+        reg.RegisterStatic("ToggleMeshCollisionBatch", &SLTPapyrusFunctionProvider::ToggleMeshCollisionBatch);
+        reg.RegisterStatic<ThreadSafety::Pure>("Tokenize", &SLTPapyrusFunctionProvider::Tokenize);
+        reg.RegisterStatic<ThreadSafety::Pure>("Tokenizev2", &SLTPapyrusFunctionProvider::Tokenizev2);
+        reg.RegisterStatic<ThreadSafety::Pure>("TokenizeForVariableSubstitution", &SLTPapyrusFunctionProvider::TokenizeForVariableSubstitution);
+        reg.RegisterStatic("TranslateToBatch", &SLTPapyrusFunctionProvider::TranslateToBatch);
+        reg.RegisterStatic<ThreadSafety::Pure>("Trim", &SLTPapyrusFunctionProvider::Trim);
     }
 };
 
@@ -147,14 +389,84 @@ class SLTInternalPapyrusFunctionProvider : public SLT::binding::PapyrusFunctionP
 public:
     // Static Papyrus function implementations
     // NON-LATENT
+    static std::int32_t AllocateVariableFrame(PAPYRUS_STATIC_ARGS) {
+        return SLT::SLTNativeFunctions::AllocateVariableFrame(PAPYRUS_FN_PARMS);
+    }
+
+    static std::int32_t BindVariableFrame(PAPYRUS_STATIC_ARGS, std::int32_t frameHandle, std::string_view scriptname) {
+        return SLT::SLTNativeFunctions::BindVariableFrame(PAPYRUS_FN_PARMS, frameHandle, scriptname);
+    }
+
+    static void CancelScriptContext(PAPYRUS_STATIC_ARGS, std::int32_t contextHandle) {
+        SLT::SLTNativeFunctions::CancelScriptContext(PAPYRUS_FN_PARMS, contextHandle);
+    }
+
+    static std::int32_t CheckTriggerGate(PAPYRUS_STATIC_ARGS, std::string_view triggerKey, RE::Actor* target, float cooldownSeconds,
+                                            float chance, bool exclusive) {
+        return SLT::SLTNativeFunctions::CheckTriggerGate(PAPYRUS_FN_PARMS, triggerKey, target, cooldownSeconds, chance, exclusive);
+    }
+
+    static void ClearEventFilters(PAPYRUS_STATIC_ARGS) {
+        SLT::SLTNativeFunctions::ClearEventFilters(PAPYRUS_FN_PARMS);
+    }
+
+    static void ClearKeyChords(PAPYRUS_STATIC_ARGS) {
+        SLT::SLTNativeFunctions::ClearKeyChords(PAPYRUS_FN_PARMS);
+    }
+
     static bool DeleteTrigger(PAPYRUS_STATIC_ARGS, std::string extKeyStr, std::string trigKeyStr) {
         return SLT::SLTNativeFunctions::DeleteTrigger(PAPYRUS_FN_PARMS, extKeyStr, trigKeyStr);
     }
 
+    static RE::BSScript::LatentStatus DeleteTriggerLatent(PAPYRUS_STATIC_ARGS, std::string_view extKeyStr, std::string_view trigKeyStr) {
+        return SLT::SLTNativeFunctions::DeleteTriggerLatent(PAPYRUS_FN_PARMS, extKeyStr, trigKeyStr);
+    }
+
+    static std::string EvaluateExpressionInFrame(PAPYRUS_STATIC_ARGS, std::int32_t frameHandle, std::string_view scriptname,
+                                            std::int32_t lineno, std::vector<std::string> tokens) {
+        return SLT::SLTNativeFunctions::EvaluateExpressionInFrame(PAPYRUS_FN_PARMS, frameHandle, scriptname, lineno, tokens);
+    }
+
+    static std::vector<std::int32_t> GetEventFilterStats(PAPYRUS_STATIC_ARGS) {
+        return SLT::SLTNativeFunctions::GetEventFilterStats(PAPYRUS_FN_PARMS);
+    }
+
+    static std::string GetFrameSlot(PAPYRUS_STATIC_ARGS, std::int32_t frameHandle, std::int32_t slot, std::string_view missing) {
+        return SLT::SLTNativeFunctions::GetFrameSlot(PAPYRUS_FN_PARMS, frameHandle, slot, missing);
+    }
+
+    static std::string GetFrameVar(PAPYRUS_STATIC_ARGS, std::int32_t frameHandle, std::string_view name, std::string_view missing) {
+        return SLT::SLTNativeFunctions::GetFrameVar(PAPYRUS_FN_PARMS, frameHandle, name, missing);
+    }
+
+    static std::string GetGlobalVar(PAPYRUS_STATIC_ARGS, std::string_view name, std::string_view missing) {
+        return SLT::SLTNativeFunctions::GetGlobalVar(PAPYRUS_FN_PARMS, name, missing);
+    }
+
+    static std::vector<std::int32_t> GetTaskQueueStats(PAPYRUS_STATIC_ARGS) {
+        return SLT::SLTNativeFunctions::GetTaskQueueStats(PAPYRUS_FN_PARMS);
+    }
+
     static std::vector<std::string> GetTriggerKeys(PAPYRUS_STATIC_ARGS, std::string_view extensionKey) {
         return SLT::SLTNativeFunctions::GetTriggerKeys(PAPYRUS_FN_PARMS, extensionKey);
     }
 
+    static RE::BSScript::LatentStatus GetTriggerKeysLatent(PAPYRUS_STATIC_ARGS, std::string_view extensionKey) {
+        return SLT::SLTNativeFunctions::GetTriggerKeysLatent(PAPYRUS_FN_PARMS, extensionKey);
+    }
+
+    static bool HasFrameVar(PAPYRUS_STATIC_ARGS, std::int32_t frameHandle, std::string_view name) {
+        return SLT::SLTNativeFunctions::HasFrameVar(PAPYRUS_FN_PARMS, frameHandle, name);
+    }
+
+    static bool HasGlobalVar(PAPYRUS_STATIC_ARGS, std::string_view name) {
+        return SLT::SLTNativeFunctions::HasGlobalVar(PAPYRUS_FN_PARMS, name);
+    }
+
+    static bool IsScriptContextRunning(PAPYRUS_STATIC_ARGS, std::int32_t contextHandle) {
+        return SLT::SLTNativeFunctions::IsScriptContextRunning(PAPYRUS_FN_PARMS, contextHandle);
+    }
+
     static void LogDebug(PAPYRUS_STATIC_ARGS, std::string_view logmsg) {
         SLT::SLTNativeFunctions::LogDebug(PAPYRUS_FN_PARMS, logmsg);
     }
@@ -171,31 +483,117 @@ public:
         SLT::SLTNativeFunctions::LogWarn(PAPYRUS_FN_PARMS, logmsg);
     }
 
+    static std::int32_t RegisterEventFilter(PAPYRUS_STATIC_ARGS, std::string_view eventName, std::int32_t kind, RE::TESObjectREFR* subject,
+                                            RE::TESObjectREFR* other, RE::TESForm* form, RE::BGSKeyword* subjectKeyword, std::int32_t state) {
+        return SLT::SLTNativeFunctions::RegisterEventFilter(PAPYRUS_FN_PARMS, eventName, kind, subject, other, form, subjectKeyword, state);
+    }
+
+    static std::int32_t RegisterKeyChord(PAPYRUS_STATIC_ARGS, std::string_view eventName, std::int32_t triggerKey,
+                                            std::vector<std::int32_t> modifiers, float holdSeconds) {
+        return SLT::SLTNativeFunctions::RegisterKeyChord(PAPYRUS_FN_PARMS, eventName, triggerKey, modifiers, holdSeconds);
+    }
+
+    static void ReleaseTriggerGate(PAPYRUS_STATIC_ARGS, std::string_view triggerKey, RE::Actor* target) {
+        SLT::SLTNativeFunctions::ReleaseTriggerGate(PAPYRUS_FN_PARMS, triggerKey, target);
+    }
+
+    static void ReleaseVariableFrame(PAPYRUS_STATIC_ARGS, std::int32_t frameHandle) {
+        SLT::SLTNativeFunctions::ReleaseVariableFrame(PAPYRUS_FN_PARMS, frameHandle);
+    }
+
     static bool RunOperationOnActor(PAPYRUS_STATIC_ARGS, RE::Actor* cmdTarget, RE::ActiveEffect* cmdPrimary,
                                             std::vector<std::string> tokens) {
         return SLT::SLTNativeFunctions::RunOperationOnActor(PAPYRUS_FN_PARMS, cmdTarget, cmdPrimary, tokens);
     }
 
+    static bool SetEventFilterDelivery(PAPYRUS_STATIC_ARGS, std::int32_t filterId, float windowSeconds, bool debounce) {
+        return SLT::SLTNativeFunctions::SetEventFilterDelivery(PAPYRUS_FN_PARMS, filterId, windowSeconds, debounce);
+    }
+
     static void SetExtensionEnabled(PAPYRUS_STATIC_ARGS, std::string_view extensionKey, bool enabledState) {
         SLT::SLTNativeFunctions::SetExtensionEnabled(PAPYRUS_FN_PARMS, extensionKey, enabledState);
     }
 
+    static bool SetFrameSlot(PAPYRUS_STATIC_ARGS, std::int32_t frameHandle, std::int32_t slot, std::string_view value) {
+        return SLT::SLTNativeFunctions::SetFrameSlot(PAPYRUS_FN_PARMS, frameHandle, slot, value);
+    }
+
+    static bool SetFrameVar(PAPYRUS_STATIC_ARGS, std::int32_t frameHandle, std::string_view name, std::string_view value) {
+        return SLT::SLTNativeFunctions::SetFrameVar(PAPYRUS_FN_PARMS, frameHandle, name, value);
+    }
+
+    static void SetGlobalVar(PAPYRUS_STATIC_ARGS, std::string_view name, std::string_view value) {
+        SLT::SLTNativeFunctions::SetGlobalVar(PAPYRUS_FN_PARMS, name, value);
+    }
+
+    static void SetTaskFrameBudget(PAPYRUS_STATIC_ARGS, float milliseconds) {
+        SLT::SLTNativeFunctions::SetTaskFrameBudget(PAPYRUS_FN_PARMS, milliseconds);
+    }
+
     static bool StartScript(PAPYRUS_STATIC_ARGS, RE::Actor* cmdTarget, std::string_view initialScriptName) {
         return SLT::SLTNativeFunctions::StartScript(PAPYRUS_FN_PARMS, cmdTarget, initialScriptName);
     }
 
+    static std::vector<std::int32_t> StartScriptBatch(PAPYRUS_STATIC_ARGS, std::vector<RE::Actor*> cmdTargets, std::string_view initialScriptName) {
+        return SLT::SLTNativeFunctions::StartScriptBatch(PAPYRUS_FN_PARMS, cmdTargets, initialScriptName);
+    }
+
+    static std::int32_t StartScriptContext(PAPYRUS_STATIC_ARGS, RE::Actor* cmdTarget, RE::ActiveEffect* cmdPrimary,
+                                            std::string_view scriptname) {
+        return SLT::SLTNativeFunctions::StartScriptContext(PAPYRUS_FN_PARMS, cmdTarget, cmdPrimary, scriptname);
+    }
+
+    static void UnregisterEventFilter(PAPYRUS_STATIC_ARGS, std::int32_t filterId) {
+        SLT::SLTNativeFunctions::UnregisterEventFilter(PAPYRUS_FN_PARMS, filterId);
+    }
+
+    static void UnregisterKeyChord(PAPYRUS_STATIC_ARGS, std::int32_t chordId) {
+        SLT::SLTNativeFunctions::UnregisterKeyChord(PAPYRUS_FN_PARMS, chordId);
+    }
+
     void RegisterAllFunctions(RE::BSScript::Internal::VirtualMachine* vm, std::string_view className) {
         SLT::binding::PapyrusRegistrar<SLTInternalPapyrusFunctionProvider> reg(vm, className);
-
+        using SLT::binding::ThreadSafety;
+
+        reg.RegisterStatic<ThreadSafety::PluginState>("AllocateVariableFrame", &SLTInternalPapyrusFunctionProvider::AllocateVariableFrame);
+        reg.RegisterStatic<ThreadSafety::PluginState>("BindVariableFrame", &SLTInternalPapyrusFunctionProvider::BindVariableFrame);
+        reg.RegisterStatic<ThreadSafety::PluginState>("CancelScriptContext", &SLTInternalPapyrusFunctionProvider::CancelScriptContext);
+        reg.RegisterStatic("CheckTriggerGate", &SLTInternalPapyrusFunctionProvider::CheckTriggerGate);
+        reg.RegisterStatic<ThreadSafety::PluginState>("ClearEventFilters", &SLTInternalPapyrusFunctionProvider::ClearEventFilters);
+        reg.RegisterStatic<ThreadSafety::PluginState>("ClearKeyChords", &SLTInternalPapyrusFunctionProvider::ClearKeyChords);
         reg.RegisterStatic("DeleteTrigger", &SLTInternalPapyrusFunctionProvider::DeleteTrigger);
-        reg.RegisterStatic("GetTriggerKeys", &SLTInternalPapyrusFunctionProvider::GetTriggerKeys);
-        reg.RegisterStatic("LogDebug", &SLTInternalPapyrusFunctionProvider::LogDebug);
-        reg.RegisterStatic("LogError", &SLTInternalPapyrusFunctionProvider::LogError);
-        reg.RegisterStatic("LogInfo", &SLTInternalPapyrusFunctionProvider::LogInfo);
-        reg.RegisterStatic("LogWarn", &SLTInternalPapyrusFunctionProvider::LogWarn);
+        reg.RegisterStaticLatent<bool>("DeleteTriggerLatent", &SLTInternalPapyrusFunctionProvider::DeleteTriggerLatent);
+        reg.RegisterStatic<ThreadSafety::PluginState>("EvaluateExpressionInFrame", &SLTInternalPapyrusFunctionProvider::EvaluateExpressionInFrame);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetEventFilterStats", &SLTInternalPapyrusFunctionProvider::GetEventFilterStats);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetFrameSlot", &SLTInternalPapyrusFunctionProvider::GetFrameSlot);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetFrameVar", &SLTInternalPapyrusFunctionProvider::GetFrameVar);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetGlobalVar", &SLTInternalPapyrusFunctionProvider::GetGlobalVar);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetTaskQueueStats", &SLTInternalPapyrusFunctionProvider::GetTaskQueueStats);
+        reg.RegisterStatic<ThreadSafety::PluginState>("GetTriggerKeys", &SLTInternalPapyrusFunctionProvider::GetTriggerKeys);
+        reg.RegisterStaticLatent<std::vector<std::string>>("GetTriggerKeysLatent", &SLTInternalPapyrusFunctionProvider::GetTriggerKeysLatent);
+        reg.RegisterStatic<ThreadSafety::PluginState>("HasFrameVar", &SLTInternalPapyrusFunctionProvider::HasFrameVar);
+        reg.RegisterStatic<ThreadSafety::PluginState>("HasGlobalVar", &SLTInternalPapyrusFunctionProvider::HasGlobalVar);
+        reg.RegisterStatic<ThreadSafety::PluginState>("IsScriptContextRunning", &SLTInternalPapyrusFunctionProvider::IsScriptContextRunning);
+        reg.RegisterStatic<ThreadSafety::PluginState>("LogDebug", &SLTInternalPapyrusFunctionProvider::LogDebug);
+        reg.RegisterStatic<ThreadSafety::PluginState>("LogError", &SLTInternalPapyrusFunctionProvider::LogError);
+        reg.RegisterStatic<ThreadSafety::PluginState>("LogInfo", &SLTInternalPapyrusFunctionProvider::LogInfo);
+        reg.RegisterStatic<ThreadSafety::PluginState>("LogWarn", &SLTInternalPapyrusFunctionProvider::LogWarn);
+        reg.RegisterStatic("RegisterEventFilter", &SLTInternalPapyrusFunctionProvider::RegisterEventFilter);
+        reg.RegisterStatic<ThreadSafety::PluginState>("RegisterKeyChord", &SLTInternalPapyrusFunctionProvider::RegisterKeyChord);
+        reg.RegisterStatic("ReleaseTriggerGate", &SLTInternalPapyrusFunctionProvider::ReleaseTriggerGate);
+        reg.RegisterStatic<ThreadSafety::PluginState>("ReleaseVariableFrame", &SLTInternalPapyrusFunctionProvider::ReleaseVariableFrame);
         reg.RegisterStatic("RunOperationOnActor", &SLTInternalPapyrusFunctionProvider::RunOperationOnActor);
+        reg.RegisterStatic<ThreadSafety::PluginState>("SetEventFilterDelivery", &SLTInternalPapyrusFunctionProvider::SetEventFilterDelivery);
         reg.RegisterStatic("SetExtensionEnabled", &SLTInternalPapyrusFunctionProvider::SetExtensionEnabled);
+        reg.RegisterStatic<ThreadSafety::PluginState>("SetFrameSlot", &SLTInternalPapyrusFunctionProvider::SetFrameSlot);
+        reg.RegisterStatic<ThreadSafety::PluginState>("SetFrameVar", &SLTInternalPapyrusFunctionProvider::SetFrameVar);
+        reg.RegisterStatic<ThreadSafety::PluginState>("SetGlobalVar", &SLTInternalPapyrusFunctionProvider::SetGlobalVar);
+        reg.RegisterStatic<ThreadSafety::PluginState>("SetTaskFrameBudget", &SLTInternalPapyrusFunctionProvider::SetTaskFrameBudget);
         reg.RegisterStatic("StartScript", &SLTInternalPapyrusFunctionProvider::StartScript);
+        reg.RegisterStatic("StartScriptBatch", &SLTInternalPapyrusFunctionProvider::StartScriptBatch);
+        reg.RegisterStatic("StartScriptContext", &SLTInternalPapyrusFunctionProvider::StartScriptContext);
+        reg.RegisterStatic<ThreadSafety::PluginState>("UnregisterEventFilter", &SLTInternalPapyrusFunctionProvider::UnregisterEventFilter);
+        reg.RegisterStatic<ThreadSafety::PluginState>("UnregisterKeyChord", &SLTInternalPapyrusFunctionProvider::UnregisterKeyChord);
     }
 };
 #pragma endregion
@@ -0,0 +1,133 @@
+#include "taskqueue.h"
+
+namespace SLT {
+
+#pragma region MainThreadQueue
+void MainThreadQueue::Enqueue(Task task, Priority priority) {
+    if (!task) {
+        return;
+    }
+    std::lock_guard lock(mutex);
+    queues[static_cast<std::size_t>(priority)].push_back(std::move(task));
+    stats.peakDepth = std::max(stats.peakDepth, DepthLocked());
+    ScheduleDrainLocked();
+}
+
+void MainThreadQueue::RunFrame() {
+    {
+        std::lock_guard lock(mutex);
+        frameHooked = true;
+        if (DepthLocked() == 0) {
+            return;
+        }
+    }
+    Drain();
+}
+
+void MainThreadQueue::SetFrameBudget(std::chrono::microseconds newBudget) {
+    std::lock_guard lock(mutex);
+    budget = std::max(newBudget, std::chrono::microseconds{ 0 });
+}
+
+std::chrono::microseconds MainThreadQueue::GetFrameBudget() const {
+    std::lock_guard lock(mutex);
+    return budget;
+}
+
+MainThreadQueue::Stats MainThreadQueue::GetStats() const {
+    std::lock_guard lock(mutex);
+    Stats result = stats;
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+        result.depth[i] = queues[i].size();
+    }
+    result.budget = budget;
+    return result;
+}
+
+void MainThreadQueue::ResetPeaks() {
+    std::lock_guard lock(mutex);
+    stats.peakDepth = DepthLocked();
+    stats.peakFrameTime = std::chrono::microseconds{ 0 };
+}
+
+std::size_t MainThreadQueue::DepthLocked() const {
+    std::size_t depth = 0;
+    for (const auto& queue : queues) {
+        depth += queue.size();
+    }
+    return depth;
+}
+
+void MainThreadQueue::ScheduleDrainLocked() {
+    if (drainScheduled || frameHooked) {
+        return;
+    }
+    auto* tasks = SKSE::GetTaskInterface();
+    if (!tasks) {
+        logger::error("MainThreadQueue: SKSE task interface unavailable");
+        return;
+    }
+    drainScheduled = true;
+    tasks->AddTask([this]() { Drain(); });
+}
+
+void MainThreadQueue::Drain() {
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    std::chrono::microseconds frameBudget;
+    {
+        std::lock_guard lock(mutex);
+        frameBudget = budget;
+    }
+
+    std::size_t ran = 0;
+    while (true) {
+        Task task;
+        {
+            std::lock_guard lock(mutex);
+            for (auto& queue : queues) {
+                if (!queue.empty()) {
+                    task = std::move(queue.front());
+                    queue.pop_front();
+                    break;
+                }
+            }
+        }
+        if (!task) {
+            break;
+        }
+
+        // tasks run unlocked so they can enqueue follow-up work
+        task();
+        ran++;
+
+        if (clock::now() - start >= frameBudget) {
+            break;
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+
+    std::lock_guard lock(mutex);
+    stats.tasksRun += ran;
+    stats.framesDrained++;
+    stats.lastFrameTime = elapsed;
+    stats.peakFrameTime = std::max(stats.peakFrameTime, elapsed);
+    if (elapsed > frameBudget) {
+        stats.framesOverBudget++;
+        logger::debug("MainThreadQueue: {} tasks took {}us against a {}us budget", ran, elapsed.count(), frameBudget.count());
+    }
+
+    drainScheduled = false;
+    if (DepthLocked() > 0) {
+        if (frameHooked) {
+            // picked up by the next RunFrame
+            stats.framesCarriedOver++;
+        } else {
+            ScheduleDrainLocked();
+        }
+    }
+}
+#pragma endregion
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+namespace SLT {
+
+#pragma region MainThreadQueue
+// Game-state work that should not run inline on the calling (often VM) thread. Tasks are
+// drained on the main thread once per frame by the main-loop hook WaitScheduler installs,
+// highest priority first, until the per-frame budget is spent; whatever is left carries over
+// to the next frame. At least one task runs per frame so a single expensive task cannot stall
+// the queue. Until the hook first runs, drains go through the SKSE task interface instead;
+// SKSE processes tasks added from within a task in the same pass, so there the budget only
+// bounds each drain, not the frame.
+class MainThreadQueue {
+public:
+    enum class Priority : std::uint8_t {
+        High,
+        Normal,
+        Low,
+
+        Count
+    };
+
+    using Task = std::function<void()>;
+
+    struct Stats {
+        std::array<std::size_t, static_cast<std::size_t>(Priority::Count)> depth{};
+        std::size_t peakDepth = 0;
+        std::uint64_t tasksRun = 0;
+        std::uint64_t framesDrained = 0;
+        std::uint64_t framesCarriedOver = 0;  // frames that ended with work still queued
+        std::uint64_t framesOverBudget = 0;   // frames where a task pushed past the budget
+        std::chrono::microseconds lastFrameTime{ 0 };
+        std::chrono::microseconds peakFrameTime{ 0 };
+        std::chrono::microseconds budget{ 0 };
+    };
+
+    static constexpr std::chrono::microseconds kDefaultBudget{ 2000 };
+
+    static MainThreadQueue& GetSingleton() {
+        static MainThreadQueue singleton;
+        return singleton;
+    }
+
+    void Enqueue(Task task, Priority priority = Priority::Normal);
+
+    // Called by the main-loop hook once per frame; main thread only
+    void RunFrame();
+
+    void SetFrameBudget(std::chrono::microseconds budget);
+    std::chrono::microseconds GetFrameBudget() const;
+
+    Stats GetStats() const;
+    void ResetPeaks();
+
+private:
+    mutable std::mutex mutex;
+    std::array<std::deque<Task>, static_cast<std::size_t>(Priority::Count)> queues;
+    std::chrono::microseconds budget = kDefaultBudget;
+    bool drainScheduled = false; // an SKSE task is queued to drain (fallback only)
+    bool frameHooked = false;    // RunFrame has been called, so drains follow the main loop
+    Stats stats;
+
+    std::size_t DepthLocked() const;
+    void ScheduleDrainLocked();
+    void Drain();
+
+    MainThreadQueue() = default;
+    MainThreadQueue(const MainThreadQueue&) = delete;
+    MainThreadQueue& operator=(const MainThreadQueue&) = delete;
+};
+#pragma endregion
+}
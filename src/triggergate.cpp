@@ -0,0 +1,307 @@
+#include "triggergate.h"
+#include "scheduler.h"
+
+namespace SLT {
+
+#pragma region TriggerGate
+namespace {
+std::uint64_t SplitMix64(std::uint64_t& x) {
+    std::uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+std::uint64_t Fnv1a(std::string_view s) {
+    std::uint64_t h = 0xCBF29CE484222325ull;
+    for (unsigned char c : s) {
+        h = (h ^ c) * 0x100000001B3ull;
+    }
+    return h;
+}
+
+double PlaySeconds() {
+    return WaitScheduler::GetSingleton().RealTimeSeconds();
+}
+
+bool ReadString(SKSE::SerializationInterface* intfc, std::string& out) {
+    std::uint32_t length = 0;
+    if (!intfc->ReadRecordData(length)) {
+        return false;
+    }
+    out.resize(length);
+    return length == 0 || intfc->ReadRecordData(out.data(), length) == length;
+}
+
+// FormID 0 gates a trigger globally and has nothing to resolve
+bool ResolveTarget(SKSE::SerializationInterface* intfc, RE::FormID saved, RE::FormID& resolved) {
+    if (saved == 0) {
+        resolved = 0;
+        return true;
+    }
+    return intfc->ResolveFormID(saved, resolved);
+}
+}
+
+float TriggerGate::Stream::NextPercent() {
+    // xoshiro128+; the top 24 bits give a uniform float in [0, 1)
+    const std::uint32_t result = state[0] + state[3];
+    const std::uint32_t t = state[1] << 9;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = std::rotl(state[3], 11);
+    return static_cast<float>(result >> 8) * (100.0f / 16777216.0f);
+}
+
+void TriggerGate::Install() {
+    auto* holder = RE::ScriptEventSourceHolder::GetSingleton();
+    if (!holder) {
+        logger::error("TriggerGate: event source holder unavailable, exclusive triggers only release through ReleaseTriggerGate");
+        return;
+    }
+    holder->AddEventSink<RE::TESActiveEffectApplyRemoveEvent>(this);
+}
+
+void TriggerGate::SeedLocked(std::string_view triggerKey, Stream& stream) const {
+    std::uint64_t mix = static_cast<std::uint32_t>(seed) ^ Fnv1a(triggerKey);
+    const std::uint64_t a = SplitMix64(mix);
+    const std::uint64_t b = SplitMix64(mix);
+    stream.state = { static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(a >> 32),
+                     static_cast<std::uint32_t>(b), static_cast<std::uint32_t>(b >> 32) };
+    if ((a | b) == 0) {
+        stream.state[0] = 1; // all-zero is the one invalid xoshiro state
+    }
+}
+
+TriggerGate::Trigger& TriggerGate::GetTriggerLocked(std::string_view triggerKey) {
+    if (auto it = triggers.find(triggerKey); it != triggers.end()) {
+        return it->second;
+    }
+
+    auto& trigger = triggers[std::string(triggerKey)];
+    SeedLocked(triggerKey, trigger.stream);
+    return trigger;
+}
+
+void TriggerGate::DropUnboundLocked(double now) {
+    std::size_t dropped = 0;
+    for (auto& [key, trigger] : triggers) {
+        dropped += std::erase_if(trigger.running, [now](const auto& entry) {
+            return entry.second.effectId == 0 && now - entry.second.passedAt > kBindTimeoutSeconds;
+        });
+    }
+    if (dropped > 0) {
+        runningCount.fetch_sub(dropped, std::memory_order_release);
+        logger::warn("TriggerGate: released {} exclusive passes whose script never started", dropped);
+    }
+}
+
+void TriggerGate::RecountRunningLocked() {
+    std::size_t count = 0;
+    for (const auto& [key, trigger] : triggers) {
+        count += trigger.running.size();
+    }
+    runningCount.store(count, std::memory_order_release);
+}
+
+TriggerGate::Result TriggerGate::Check(std::string_view triggerKey, RE::FormID target, float cooldownSeconds, float chance, bool exclusive) {
+    const double now = PlaySeconds();
+
+    std::lock_guard lock(mutex);
+    auto& trigger = GetTriggerLocked(triggerKey);
+
+    if (exclusive) {
+        if (auto it = trigger.running.find(target); it != trigger.running.end()) {
+            if (it->second.effectId != 0 || now - it->second.passedAt <= kBindTimeoutSeconds) {
+                return kAlreadyRunning;
+            }
+            // the cast for this pass never produced an effect
+            trigger.running.erase(it);
+            runningCount.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    if (cooldownSeconds > 0.0f) {
+        if (auto it = trigger.lastFired.find(target); it != trigger.lastFired.end()) {
+            if (now - it->second < cooldownSeconds) {
+                return kOnCooldown;
+            }
+        }
+    }
+
+    // roll only once the cheaper checks pass, so blocked evaluations don't advance the stream
+    if (chance < 100.0f && trigger.stream.NextPercent() >= chance) {
+        return kChanceFailed;
+    }
+
+    trigger.lastFired[target] = now;
+    if (exclusive) {
+        trigger.running[target] = Running{ nextOrder++, now };
+        runningCount.fetch_add(1, std::memory_order_release);
+    }
+    return kPass;
+}
+
+void TriggerGate::Release(std::string_view triggerKey, RE::FormID target) {
+    std::lock_guard lock(mutex);
+    if (auto it = triggers.find(triggerKey); it != triggers.end() && it->second.running.erase(target) > 0) {
+        runningCount.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void TriggerGate::Reseed(SLTSessionId sessionId) {
+    std::lock_guard lock(mutex);
+    seed = sessionId;
+    for (auto& [key, trigger] : triggers) {
+        SeedLocked(key, trigger.stream);
+    }
+}
+
+void TriggerGate::Clear() {
+    std::lock_guard lock(mutex);
+    for (auto& [key, trigger] : triggers) {
+        trigger.lastFired.clear();
+        trigger.running.clear();
+    }
+    runningCount.store(0, std::memory_order_release);
+}
+
+void TriggerGate::Save(SKSE::SerializationInterface* intfc) {
+    const double now = PlaySeconds();
+
+    std::lock_guard lock(mutex);
+    if (!intfc->OpenRecord(kRecord, kRecordVersion) || !intfc->WriteRecordData(static_cast<std::uint32_t>(triggers.size()))) {
+        logger::error("TriggerGate: failed to write gate record");
+        return;
+    }
+    for (const auto& [key, trigger] : triggers) {
+        bool ok = intfc->WriteRecordData(static_cast<std::uint32_t>(key.size())) &&
+                  intfc->WriteRecordData(key.data(), static_cast<std::uint32_t>(key.size())) &&
+                  intfc->WriteRecordData(static_cast<std::uint32_t>(trigger.lastFired.size()));
+        for (const auto& [target, firedAt] : trigger.lastFired) {
+            // stored as time since firing, since the play clock starts over with each launch
+            ok = ok && intfc->WriteRecordData(target) && intfc->WriteRecordData(now - firedAt);
+        }
+        ok = ok && intfc->WriteRecordData(static_cast<std::uint32_t>(trigger.running.size()));
+        for (const auto& [target, running] : trigger.running) {
+            ok = ok && intfc->WriteRecordData(target) && intfc->WriteRecordData(running.effectId);
+        }
+        if (!ok) {
+            logger::error("TriggerGate: failed to write trigger {}", key);
+            return;
+        }
+    }
+}
+
+void TriggerGate::Load(SKSE::SerializationInterface* intfc, std::uint32_t version) {
+    if (version != kRecordVersion) {
+        logger::error("TriggerGate: unsupported record version {}", version);
+        return;
+    }
+    const double now = PlaySeconds();
+
+    std::lock_guard lock(mutex);
+    triggers.clear();
+
+    std::uint32_t triggerCount = 0;
+    intfc->ReadRecordData(triggerCount);
+    for (std::uint32_t i = 0; i < triggerCount; ++i) {
+        std::string key;
+        std::uint32_t firedCount = 0;
+        if (!ReadString(intfc, key) || !intfc->ReadRecordData(firedCount)) {
+            logger::error("TriggerGate: failed to read gate record");
+            break;
+        }
+        auto& trigger = GetTriggerLocked(key);
+
+        bool ok = true;
+        for (std::uint32_t j = 0; ok && j < firedCount; ++j) {
+            RE::FormID target = 0;
+            double elapsed = 0.0;
+            ok = intfc->ReadRecordData(target) && intfc->ReadRecordData(elapsed);
+            // targets from plugins no longer loaded are dropped
+            if (ok && ResolveTarget(intfc, target, target)) {
+                trigger.lastFired[target] = now - elapsed;
+            }
+        }
+
+        std::uint32_t runningEntries = 0;
+        ok = ok && intfc->ReadRecordData(runningEntries);
+        for (std::uint32_t j = 0; ok && j < runningEntries; ++j) {
+            RE::FormID target = 0;
+            std::uint16_t effectId = 0;
+            ok = intfc->ReadRecordData(target) && intfc->ReadRecordData(effectId);
+            if (ok && ResolveTarget(intfc, target, target)) {
+                trigger.running[target] = Running{ nextOrder++, now, effectId };
+            }
+        }
+
+        if (!ok) {
+            logger::error("TriggerGate: failed to read trigger {}", key);
+            break;
+        }
+    }
+    RecountRunningLocked();
+}
+
+void TriggerGate::ValidateRunning() {
+    std::lock_guard lock(mutex);
+    std::size_t dropped = 0;
+    for (auto& [key, trigger] : triggers) {
+        dropped += std::erase_if(trigger.running, [](const auto& entry) {
+            const auto& [target, running] = entry;
+            // an unbound pass was waiting on a cast that the load discarded
+            return running.effectId == 0 || !ScriptPoolManager::FindActiveEffect(RE::TESForm::LookupByID<RE::TESObjectREFR>(target), running.effectId);
+        });
+    }
+    RecountRunningLocked();
+    if (dropped > 0) {
+        logger::info("TriggerGate: released {} exclusive runs whose effect did not survive the load", dropped);
+    }
+}
+
+RE::BSEventNotifyControl TriggerGate::ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event,
+                                                   RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>*) {
+    if (!a_event || !a_event->target || runningCount.load(std::memory_order_acquire) == 0) {
+        return RE::BSEventNotifyControl::kContinue;
+    }
+
+    const auto target = a_event->target->GetFormID();
+    const auto effectId = a_event->activeEffectUniqueID;
+
+    if (a_event->isApplied) {
+        auto* effect = ScriptPoolManager::FindActiveEffect(a_event->target.get(), effectId);
+        if (!effect || !ScriptPoolManager::GetSingleton().IsPoolEffect(effect->GetBaseObject())) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
+        const double now = PlaySeconds();
+        std::lock_guard lock(mutex);
+        // a stale pass must not take the effect of a script started after it
+        DropUnboundLocked(now);
+        Running* oldest = nullptr;
+        for (auto& [key, trigger] : triggers) {
+            if (auto it = trigger.running.find(target); it != trigger.running.end() && it->second.effectId == 0 &&
+                (!oldest || it->second.order < oldest->order)) {
+                oldest = &it->second;
+            }
+        }
+        if (oldest) {
+            oldest->effectId = effectId;
+        }
+    } else {
+        std::lock_guard lock(mutex);
+        for (auto& [key, trigger] : triggers) {
+            if (auto it = trigger.running.find(target); it != trigger.running.end() && it->second.effectId == effectId) {
+                trigger.running.erase(it);
+                runningCount.fetch_sub(1, std::memory_order_release);
+            }
+        }
+    }
+    return RE::BSEventNotifyControl::kContinue;
+}
+#pragma endregion
+}
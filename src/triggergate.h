@@ -0,0 +1,102 @@
+#pragma once
+
+namespace SLT {
+
+#pragma region TriggerGate
+// Cooldowns, run-once-per-actor and chance rolls for trigger firing, decided in one call.
+// Chance rolls draw from a per-trigger xoshiro128+ stream seeded from the session id, so a
+// session replays the same roll sequence per trigger regardless of how other triggers fire.
+// Cooldowns run on unpaused play time (WaitScheduler's real-time clock) and, with the running
+// markers, are kept in the cosave, so loading a game restores them as they were when it was
+// saved; only the streams start over with each session.
+//
+// An exclusive pass counts as running until ReleaseTriggerGate or until the script's effect
+// ends. The effect is not known when the gate is checked, so each pass is bound to the next
+// SLT pool effect applied to its target, oldest pass first. A pass still unbound after
+// kBindTimeoutSeconds of play is taken to mean the script never started and is dropped.
+class TriggerGate : public RE::BSTEventSink<RE::TESActiveEffectApplyRemoveEvent> {
+public:
+    enum Result : std::int32_t {
+        kPass = 1,
+        kChanceFailed = 0,
+        kOnCooldown = -1,
+        kAlreadyRunning = -2
+    };
+
+    static constexpr std::uint32_t kRecord = 'GATE';
+    static constexpr std::uint32_t kRecordVersion = 1;
+
+    // how long a pass may wait for its script's effect before it no longer counts as running
+    static constexpr double kBindTimeoutSeconds = 10.0;
+
+    static TriggerGate& GetSingleton() {
+        static TriggerGate singleton;
+        return singleton;
+    }
+
+    // Registers for effect apply/remove events; call once data is loaded
+    void Install();
+
+    // On kPass the firing is recorded: the cooldown starts and, if exclusive, the pair is marked
+    // running until Release or its effect ends. chance is a percentage; >= 100 always passes.
+    Result Check(std::string_view triggerKey, RE::FormID target, float cooldownSeconds, float chance, bool exclusive);
+    void Release(std::string_view triggerKey, RE::FormID target);
+
+    // Reseeds the chance streams, e.g. when a new session id is generated; everything else is kept
+    void Reseed(SLTSessionId sessionId);
+
+    // Drops cooldowns and running markers, e.g. for a new game
+    void Clear();
+
+    // Cosave record, written and read from VariableStore's serialization callbacks
+    void Save(SKSE::SerializationInterface* intfc);
+    void Load(SKSE::SerializationInterface* intfc, std::uint32_t version);
+
+    // After a load: drops running markers whose effect did not survive it; main thread only
+    void ValidateRunning();
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESActiveEffectApplyRemoveEvent* a_event,
+                                          RE::BSTEventSource<RE::TESActiveEffectApplyRemoveEvent>*) override;
+
+private:
+    struct Stream {
+        std::array<std::uint32_t, 4> state;
+
+        float NextPercent();
+    };
+
+    struct Running {
+        std::uint64_t order;         // pass sequence; the oldest unbound pass binds first
+        double passedAt = 0.0;       // play seconds
+        std::uint16_t effectId = 0;  // unique id of the script's active effect on the target; 0 until it starts
+    };
+
+    struct Trigger {
+        Stream stream;
+        std::unordered_map<RE::FormID, double> lastFired; // play seconds
+        std::unordered_map<RE::FormID, Running> running;
+    };
+
+    // transparent so lookups by string_view do not allocate
+    struct KeyHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
+    std::mutex mutex;
+    SLTSessionId seed = 0;
+    std::unordered_map<std::string, Trigger, KeyHash, std::equal_to<>> triggers;
+    std::uint64_t nextOrder = 1;
+    std::atomic<std::size_t> runningCount = 0; // lets effect events skip the lock while nothing runs
+
+    Trigger& GetTriggerLocked(std::string_view triggerKey);
+    void SeedLocked(std::string_view triggerKey, Stream& stream) const;
+    void RecountRunningLocked();
+    void DropUnboundLocked(double now);
+
+    TriggerGate() = default;
+    TriggerGate(const TriggerGate&) = delete;
+    TriggerGate& operator=(const TriggerGate&) = delete;
+};
+#pragma endregion
+}
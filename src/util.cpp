@@ -345,6 +345,127 @@ NiMatrix3 MathUtil::Angle::QuaternionToMatrix(const NiQuaternion& a_quat) {
     return ret;
 }
 
+//=================================================================================================
+// MathUtil::Batch implementations
+//=================================================================================================
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define SLT_BATCH_SSE 1
+#include <cfloat>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif
+
+namespace {
+#ifdef SLT_BATCH_SSE
+    inline __m128 SelectPs(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // atan2 for four lanes, within ~3e-7 rad of std::atan2 (Cephes atanf polynomial)
+    inline __m128 Atan2Ps(__m128 y, __m128 x) {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        const __m128 ax = _mm_andnot_ps(signMask, x);
+        const __m128 ay = _mm_andnot_ps(signMask, y);
+        const __m128 hi = _mm_max_ps(ax, ay);
+        const __m128 lo = _mm_min_ps(ax, ay);
+        // lo/hi is in [0, 1]; both zero yields 0 like std::atan2
+        const __m128 a = _mm_div_ps(lo, _mm_max_ps(hi, _mm_set1_ps(FLT_MIN)));
+
+        // reduce to [0, tan(pi/8)] via atan(a) = pi/4 + atan((a - 1) / (a + 1))
+        const __m128 reduce = _mm_cmpgt_ps(a, _mm_set1_ps(0.41421356f));
+        const __m128 t = SelectPs(reduce, _mm_div_ps(_mm_sub_ps(a, one), _mm_add_ps(a, one)), a);
+        const __m128 z = _mm_mul_ps(t, t);
+
+        __m128 poly = _mm_set1_ps(8.05374449538e-2f);
+        poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(-1.38776856032e-1f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(1.99777106478e-1f));
+        poly = _mm_add_ps(_mm_mul_ps(poly, z), _mm_set1_ps(-3.33329491539e-1f));
+        __m128 r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(poly, z), t), t);
+        r = _mm_add_ps(r, _mm_and_ps(reduce, _mm_set1_ps(PI4)));
+
+        // back out to the full circle
+        r = SelectPs(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(PI2), r), r);
+        r = SelectPs(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(PI), r), r);
+        return _mm_or_ps(r, _mm_and_ps(signMask, y));
+    }
+#endif
+}
+
+void MathUtil::Batch::GetAngles(const RE::NiPoint3& a_from, const Points& a_to, std::span<float> a_angleZ, std::span<float> a_angleX, std::span<float> a_distance) {
+    const std::size_t count = std::min({ a_to.size(), a_angleZ.size(), a_angleX.size(), a_distance.size() });
+    std::size_t i = 0;
+
+#ifdef SLT_BATCH_SSE
+    const __m128 fromX = _mm_set1_ps(a_from.x);
+    const __m128 fromY = _mm_set1_ps(a_from.y);
+    const __m128 fromZ = _mm_set1_ps(a_from.z);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 x = _mm_sub_ps(_mm_loadu_ps(&a_to.x[i]), fromX);
+        const __m128 y = _mm_sub_ps(_mm_loadu_ps(&a_to.y[i]), fromY);
+        const __m128 z = _mm_sub_ps(_mm_loadu_ps(&a_to.z[i]), fromZ);
+        const __m128 xy2 = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        const __m128 xy = _mm_sqrt_ps(xy2);
+
+        _mm_storeu_ps(&a_angleZ[i], Atan2Ps(x, y));
+        _mm_storeu_ps(&a_angleX[i], Atan2Ps(_mm_sub_ps(_mm_setzero_ps(), z), xy));
+        _mm_storeu_ps(&a_distance[i], _mm_sqrt_ps(_mm_add_ps(xy2, _mm_mul_ps(z, z))));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const float x = a_to.x[i] - a_from.x;
+        const float y = a_to.y[i] - a_from.y;
+        const float z = a_to.z[i] - a_from.z;
+        const float xy = std::sqrt(x * x + y * y);
+
+        a_angleZ[i] = std::atan2(x, y);
+        a_angleX[i] = std::atan2(-z, xy);
+        a_distance[i] = std::sqrt(xy * xy + z * z);
+    }
+}
+
+void MathUtil::Batch::RotateVectors(const Points& a_vecs, const RE::NiQuaternion& a_quat, Points& a_out) {
+    const std::size_t count = a_vecs.size();
+    a_out.resize(count);
+    std::size_t i = 0;
+
+#ifdef SLT_BATCH_SSE
+    // same formulation as Angle::RotateVector: T = 2 (Q x v), v' = v + wT + Q x T
+    const __m128 qx = _mm_set1_ps(a_quat.x);
+    const __m128 qy = _mm_set1_ps(a_quat.y);
+    const __m128 qz = _mm_set1_ps(a_quat.z);
+    const __m128 qw = _mm_set1_ps(a_quat.w);
+    const __m128 two = _mm_set1_ps(2.f);
+    for (; i + 4 <= count; i += 4) {
+        const __m128 vx = _mm_loadu_ps(&a_vecs.x[i]);
+        const __m128 vy = _mm_loadu_ps(&a_vecs.y[i]);
+        const __m128 vz = _mm_loadu_ps(&a_vecs.z[i]);
+
+        const __m128 tx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qy, vz), _mm_mul_ps(qz, vy)), two);
+        const __m128 ty = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qz, vx), _mm_mul_ps(qx, vz)), two);
+        const __m128 tz = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(qx, vy), _mm_mul_ps(qy, vx)), two);
+
+        const __m128 cx = _mm_sub_ps(_mm_mul_ps(qy, tz), _mm_mul_ps(qz, ty));
+        const __m128 cy = _mm_sub_ps(_mm_mul_ps(qz, tx), _mm_mul_ps(qx, tz));
+        const __m128 cz = _mm_sub_ps(_mm_mul_ps(qx, ty), _mm_mul_ps(qy, tx));
+
+        _mm_storeu_ps(&a_out.x[i], _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(tx, qw)), cx));
+        _mm_storeu_ps(&a_out.y[i], _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(ty, qw)), cy));
+        _mm_storeu_ps(&a_out.z[i], _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(tz, qw)), cz));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        const auto rotated = Angle::RotateVector({ a_vecs.x[i], a_vecs.y[i], a_vecs.z[i] }, a_quat);
+        a_out.x[i] = rotated.x;
+        a_out.y[i] = rotated.y;
+        a_out.z[i] = rotated.z;
+    }
+}
+
 //=================================================================================================
 // MathUtil::Interp implementations
 //=================================================================================================
@@ -375,6 +496,21 @@ void ObjectUtil::Transform::TranslateTo(RE::BSScript::IVirtualMachine *vm, RE::V
     func(vm, stackID, object, afX, afY, afZ, afAngleX, afAngleY, afAngleZ, afSpeed, afMaxRotationSpeed);
 }
 
+std::size_t ObjectUtil::Transform::TranslateBatch(RE::BSScript::IVirtualMachine *vm, RE::VMStackID stackID, std::span<const TranslateTarget> targets, float afSpeed, float afMaxRotationSpeed) {
+    std::size_t started = 0;
+    for (const auto& target : targets) {
+        // handles can outlive the ref, and a ref can be unloaded
+        auto ref = target.ref.get();
+        if (!ref || !ref->Is3DLoaded()) {
+            continue;
+        }
+        TranslateTo(vm, stackID, ref.get(), target.position.x, target.position.y, target.position.z,
+            target.angle.x, target.angle.y, target.angle.z, afSpeed, afMaxRotationSpeed);
+        started++;
+    }
+    return started;
+}
+
 float ObjectUtil::Transform::InterpAngleTo(float a_current, float a_target, float a_deltaTime, float a_interpSpeed) {
     if (a_interpSpeed <= 0.f) {
         return a_target;
@@ -395,6 +531,59 @@ float ObjectUtil::Transform::Clamp(float value, float min, float max) {
     return value < min ? min : value < max ? value : max;
 }
 
+//=================================================================================================
+// ObjectUtil::Scan implementations
+//=================================================================================================
+
+std::vector<RE::Actor*> ObjectUtil::Scan::FindActorsInRadius(const RE::NiPoint3& center, float radius, const ActorFilter& filter, std::size_t maxCount) {
+    std::vector<std::pair<float, RE::Actor*>> matches;
+    if (radius <= 0.f || maxCount == 0) {
+        return {};
+    }
+    const float radiusSquared = radius * radius;
+
+    auto consider = [&](RE::Actor* actor) {
+        if (!actor || actor == filter.exclude || !actor->Is3DLoaded()) {
+            return;
+        }
+        // cheapest test first; most loaded actors are out of range
+        const float distanceSquared = center.GetSquaredDistance(actor->GetPosition());
+        if (distanceSquared > radiusSquared) {
+            return;
+        }
+        if (filter.aliveOnly && actor->IsDead()) return;
+        if (filter.inCombatOnly && !actor->IsInCombat()) return;
+        if (filter.race && actor->GetRace() != filter.race) return;
+        if (filter.faction && !actor->IsInFaction(filter.faction)) return;
+        if (filter.keyword && !actor->HasKeyword(filter.keyword)) return;
+        matches.emplace_back(distanceSquared, actor);
+    };
+
+    if (auto* processLists = RE::ProcessLists::GetSingleton()) {
+        for (auto* handles : { &processLists->highActorHandles, &processLists->middleHighActorHandles }) {
+            for (const auto& handle : *handles) {
+                consider(handle.get().get());
+            }
+        }
+    }
+    consider(RE::PlayerCharacter::GetSingleton());
+
+    auto byDistance = [](const auto& a, const auto& b) { return a.first < b.first; };
+    if (matches.size() > maxCount) {
+        std::partial_sort(matches.begin(), matches.begin() + maxCount, matches.end(), byDistance);
+        matches.resize(maxCount);
+    } else {
+        std::sort(matches.begin(), matches.end(), byDistance);
+    }
+
+    std::vector<RE::Actor*> result;
+    result.reserve(matches.size());
+    for (const auto& [distanceSquared, actor] : matches) {
+        result.push_back(actor);
+    }
+    return result;
+}
+
 //=================================================================================================
 // AnimUtil::Idle implementations
 //=================================================================================================
@@ -574,16 +763,7 @@ std::vector<BSGeometry*> NifUtil::Node::GetAllGeometries(RE::NiAVObject* root) {
 //=================================================================================================
 
 RE::NiNode* NifUtil::Armature::GetActorNode(RE::Actor* actor, std::string nodeName) {
-    auto root = actor->Get3D();
-    if (!root) return nullptr;
-
-    auto bone = root->GetObjectByName(nodeName);
-    if (!bone) return nullptr;
-
-    auto node = bone->AsNode();
-    if (!node) return nullptr;
-
-    return node;
+    return ActorNodeCache::GetSingleton().GetNode(actor, nodeName);
 }
 
 void NifUtil::Armature::AttachToNode(RE::NiAVObject* obj, RE::Actor* actor, std::string nodeName) {
@@ -594,32 +774,198 @@ void NifUtil::Armature::AttachToNode(RE::NiAVObject* obj, RE::Actor* actor, std:
     }
 }
 
+std::vector<BSGeometry*> NifUtil::Armature::GetActorGeometries(RE::Actor* actor) {
+    return ActorNodeCache::GetSingleton().GetGeometries(actor);
+}
+
+//=================================================================================================
+// NifUtil::ActorNodeCache implementations
+//=================================================================================================
+
+namespace {
+    bool IsAttachedUnder(RE::NiAVObject* object, RE::NiAVObject* root) {
+        for (auto* current = object; current; current = current->parent) {
+            if (current == root) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+void NifUtil::ActorNodeCache::Install() {
+    auto* holder = RE::ScriptEventSourceHolder::GetSingleton();
+    if (!holder) {
+        logger::error("ActorNodeCache: event source holder unavailable, node cache will only self-validate");
+        return;
+    }
+    holder->AddEventSink<RE::TESObjectLoadedEvent>(this);
+    holder->AddEventSink<RE::TESEquipEvent>(this);
+}
+
+NifUtil::ActorNodeCache::Entry& NifUtil::ActorNodeCache::EntryForLocked(RE::FormID formID, RE::NiAVObject* root) {
+    auto& entry = entries[formID];
+    if (entry.root.get() != root) {
+        // holding the root keeps its address from being reused while the entry exists
+        entry = Entry{};
+        entry.root = RE::NiPointer<RE::NiAVObject>(root);
+    }
+    return entry;
+}
+
+RE::NiNode* NifUtil::ActorNodeCache::GetNode(RE::Actor* actor, std::string_view nodeName) {
+    if (!actor) return nullptr;
+
+    auto* root = actor->Get3D();
+    if (!root) {
+        Invalidate(actor->GetFormID());
+        return nullptr;
+    }
+
+    std::lock_guard lock(mutex);
+    auto& entry = EntryForLocked(actor->GetFormID(), root);
+
+    auto key = Util::String::ToLower(nodeName);
+    if (auto it = entry.nodes.find(key); it != entry.nodes.end()) {
+        // nodes can be detached (e.g. weapons sheathed) without the root changing
+        if (IsAttachedUnder(it->second.get(), root)) {
+            return it->second.get();
+        }
+        entry.nodes.erase(it);
+    }
+
+    auto* bone = root->GetObjectByName(std::string(nodeName));
+    auto* node = bone ? bone->AsNode() : nullptr;
+    if (node) {
+        entry.nodes.emplace(std::move(key), RE::NiPointer<RE::NiNode>(node));
+    }
+    return node;
+}
+
+std::vector<BSGeometry*> NifUtil::ActorNodeCache::GetGeometries(RE::Actor* actor) {
+    if (!actor) return {};
+
+    auto* root = actor->Get3D();
+    if (!root) {
+        Invalidate(actor->GetFormID());
+        return {};
+    }
+
+    std::lock_guard lock(mutex);
+    auto& entry = EntryForLocked(actor->GetFormID(), root);
+
+    if (!entry.geometries) {
+        auto& geometries = entry.geometries.emplace();
+        RE::BSVisit::TraverseScenegraphGeometries(root, [&](BSGeometry* geom) -> RE::BSVisit::BSVisitControl {
+            geometries.emplace_back(geom);
+            return RE::BSVisit::BSVisitControl::kContinue;
+        });
+    }
+
+    std::vector<BSGeometry*> result;
+    result.reserve(entry.geometries->size());
+    for (const auto& geom : *entry.geometries) {
+        result.push_back(geom.get());
+    }
+    return result;
+}
+
+void NifUtil::ActorNodeCache::Invalidate(RE::FormID formID) {
+    std::lock_guard lock(mutex);
+    entries.erase(formID);
+}
+
+void NifUtil::ActorNodeCache::Clear() {
+    std::lock_guard lock(mutex);
+    entries.clear();
+}
+
+RE::BSEventNotifyControl NifUtil::ActorNodeCache::ProcessEvent(const RE::TESObjectLoadedEvent* a_event, RE::BSTEventSource<RE::TESObjectLoadedEvent>*) {
+    if (a_event) {
+        Invalidate(a_event->formID);
+    }
+    return RE::BSEventNotifyControl::kContinue;
+}
+
+RE::BSEventNotifyControl NifUtil::ActorNodeCache::ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>*) {
+    if (a_event && a_event->actor) {
+        std::lock_guard lock(mutex);
+        if (auto it = entries.find(a_event->actor->GetFormID()); it != entries.end()) {
+            it->second.geometries.reset();
+        }
+    }
+    return RE::BSEventNotifyControl::kContinue;
+}
+
 //=================================================================================================
 // NifUtil::Collision implementations
 //=================================================================================================
 
-bool NifUtil::Collision::ToggleMeshCollision(RE::NiAVObject* root, RE::bhkWorld* world, bool collisionState) {
+void NifUtil::Collision::ApplyCollisionState(RE::NiAVObject* root, bool collisionState) {
     constexpr auto no_collision_flag = static_cast<std::uint32_t>(RE::CFilter::Flag::kNoCollision);
+    RE::BSVisit::TraverseScenegraphCollision(root, [&](RE::bhkNiCollisionObject* a_col) -> RE::BSVisit::BSVisitControl {
+        if (auto hkpBody = a_col->body ? static_cast<RE::hkpWorldObject*>(a_col->body->referencedObject.get()) : nullptr; hkpBody) {
+            auto& filter = hkpBody->collidable.broadPhaseHandle.collisionFilterInfo;
+            if (!collisionState) {
+                filter |= no_collision_flag;
+            } else {
+                filter &= ~no_collision_flag;
+            }
+        }
+        return RE::BSVisit::BSVisitControl::kContinue;
+    });
+}
+
+bool NifUtil::Collision::ToggleMeshCollision(RE::NiAVObject* root, RE::bhkWorld* world, bool collisionState) {
     if (root && world) {
         RE::BSWriteLockGuard locker(world->worldLock);
-
-        RE::BSVisit::TraverseScenegraphCollision(root, [&](RE::bhkNiCollisionObject* a_col) -> RE::BSVisit::BSVisitControl {
-            if (auto hkpBody = a_col->body ? static_cast<RE::hkpWorldObject*>(a_col->body->referencedObject.get()) : nullptr; hkpBody) {
-                auto& filter = hkpBody->collidable.broadPhaseHandle.collisionFilterInfo;
-                if (!collisionState) {
-                    filter |= no_collision_flag;
-                } else {
-                    filter &= ~no_collision_flag;
-                }
-            }
-            return RE::BSVisit::BSVisitControl::kContinue;
-        });
+        ApplyCollisionState(root, collisionState);
     } else {
         return false;
     }
     return true;
 }
 
+NifUtil::Collision::BatchStats NifUtil::Collision::ToggleMeshCollision(std::span<RE::TESObjectREFR* const> refs, bool collisionState) {
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+
+    BatchStats stats;
+    // batches are small and usually share one world, so a flat list beats a map here
+    std::vector<std::pair<RE::bhkWorld*, std::vector<RE::NiAVObject*>>> byWorld;
+
+    for (auto* ref : refs) {
+        auto* root = ref ? ref->Get3D() : nullptr;
+        auto* cell = ref ? ref->GetParentCell() : nullptr;
+        auto* world = cell ? cell->GetbhkWorld() : nullptr;
+        if (!root || !world) {
+            stats.skipped++;
+            continue;
+        }
+
+        auto it = std::ranges::find(byWorld, world, &decltype(byWorld)::value_type::first);
+        if (it == byWorld.end()) {
+            byWorld.emplace_back(world, std::vector<RE::NiAVObject*>{});
+            it = std::prev(byWorld.end());
+        }
+        if (std::ranges::find(it->second, root) == it->second.end()) {
+            it->second.push_back(root);
+        }
+    }
+
+    for (auto& [world, roots] : byWorld) {
+        RE::BSWriteLockGuard locker(world->worldLock);
+        for (auto* root : roots) {
+            ApplyCollisionState(root, collisionState);
+        }
+        stats.roots += roots.size();
+    }
+
+    stats.worlds = byWorld.size();
+    stats.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start);
+    return stats;
+}
+
 bool NifUtil::Collision::RemoveMeshCollision(RE::NiAVObject* root, RE::bhkWorld* world, bool collisionState) {
     constexpr auto no_collision_flag = static_cast<std::uint32_t>(RE::CFilter::Flag::kNoCollision);
     if (root && world) {
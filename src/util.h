@@ -16,11 +16,11 @@ using namespace RE;
 namespace SystemUtil { struct File; }
 namespace KeyUtil { struct Interpreter; }
 namespace Util { struct String; }
-namespace MathUtil { struct Angle; struct Interp; }
-namespace ObjectUtil { struct Transform; }
+namespace MathUtil { struct Angle; struct Interp; struct Batch; }
+namespace ObjectUtil { struct Transform; struct Scan; }
 namespace AnimUtil { struct Idle; }
 namespace FormUtil { struct Parse; struct Quest; }
-namespace NifUtil { struct Node; struct Armature; struct Collision; }
+namespace NifUtil { struct Node; struct Armature; struct Collision; class ActorNodeCache; }
 
 //=================================================================================================
 // CLASS DECLARATIONS
@@ -188,16 +188,63 @@ namespace MathUtil
     {
         [[nodiscard]] static float InterpTo(float a_current, float a_target, float a_deltaTime, float a_interpSpeed);
     };
+
+    // Angle kernels over structure-of-arrays input, four points per SSE step with a scalar tail
+    struct Batch
+    {
+        struct Points
+        {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+
+            [[nodiscard]] std::size_t size() const { return x.size(); }
+            void reserve(std::size_t n) { x.reserve(n); y.reserve(n); z.reserve(n); }
+            void resize(std::size_t n) { x.resize(n); y.resize(n); z.resize(n); }
+            void push_back(const RE::NiPoint3& p) { x.push_back(p.x); y.push_back(p.y); z.push_back(p.z); }
+        };
+
+        // Angle::GetAngle from a_from to every point, in float; each output needs a_to.size() entries
+        static void GetAngles(const RE::NiPoint3& a_from, const Points& a_to, std::span<float> a_angleZ, std::span<float> a_angleX, std::span<float> a_distance);
+        // Angle::RotateVector for every vector; a_out is resized to match
+        static void RotateVectors(const Points& a_vecs, const RE::NiQuaternion& a_quat, Points& a_out);
+    };
 }
 
 namespace ObjectUtil
 { 
     struct Transform
     {
+        struct TranslateTarget
+        {
+            RE::ObjectRefHandle ref;
+            RE::NiPoint3 position;
+            RE::NiPoint3 angle;     // degrees, as Papyrus TranslateTo takes them
+        };
+
         static void TranslateTo(RE::BSScript::IVirtualMachine *vm, RE::VMStackID stackID, RE::TESObjectREFR *object, float afX, float afY, float afZ, float afAngleX, float afAngleY, float afAngleZ, float afSpeed, float afMaxRotationSpeed);
+        // Issues TranslateTo for every target still loaded; returns how many were started. Main thread only.
+        static std::size_t TranslateBatch(RE::BSScript::IVirtualMachine *vm, RE::VMStackID stackID, std::span<const TranslateTarget> targets, float afSpeed, float afMaxRotationSpeed);
         static float InterpAngleTo(float a_current, float a_target, float a_deltaTime, float a_interpSpeed);
         static float Clamp(float value, float min, float max);
     };
+
+    struct Scan
+    {
+        struct ActorFilter
+        {
+            RE::BGSKeyword* keyword = nullptr;
+            RE::TESFaction* faction = nullptr;
+            RE::TESRace* race = nullptr;
+            bool aliveOnly = false;
+            bool inCombatOnly = false;
+            RE::Actor* exclude = nullptr;
+        };
+
+        // One pass over the loaded (high and middle-high process) actors plus the player. Returns the
+        // nearest maxCount matches within radius, closest first.
+        static std::vector<RE::Actor*> FindActorsInRadius(const RE::NiPoint3& center, float radius, const ActorFilter& filter, std::size_t maxCount);
+    };
 }
 
 namespace AnimUtil
@@ -243,11 +290,70 @@ namespace NifUtil
     {
         static RE::NiNode* GetActorNode(RE::Actor* actor, std::string nodeName);
         static void AttachToNode(RE::NiAVObject* obj, RE::Actor* actor, std::string nodeName);
+        static std::vector<BSGeometry*> GetActorGeometries(RE::Actor* actor);
+    };
+
+    // Per-actor node lookups and geometry lists, tied to the 3D root they were built from so a
+    // reloaded actor never sees stale pointers. Entries are dropped when the actor's 3D loads or
+    // unloads; geometry lists also when it equips or unequips something.
+    class ActorNodeCache :
+        public RE::BSTEventSink<RE::TESObjectLoadedEvent>,
+        public RE::BSTEventSink<RE::TESEquipEvent>
+    {
+    public:
+        static ActorNodeCache& GetSingleton() {
+            static ActorNodeCache singleton;
+            return singleton;
+        }
+
+        // Registers the load/equip sinks; call once game data is loaded
+        void Install();
+
+        RE::NiNode* GetNode(RE::Actor* actor, std::string_view nodeName);
+        std::vector<BSGeometry*> GetGeometries(RE::Actor* actor);
+
+        void Invalidate(RE::FormID formID);
+        void Clear();
+
+        RE::BSEventNotifyControl ProcessEvent(const RE::TESObjectLoadedEvent* a_event, RE::BSTEventSource<RE::TESObjectLoadedEvent>*) override;
+        RE::BSEventNotifyControl ProcessEvent(const RE::TESEquipEvent* a_event, RE::BSTEventSource<RE::TESEquipEvent>*) override;
+
+    private:
+        struct Entry
+        {
+            RE::NiPointer<RE::NiAVObject> root;
+            std::unordered_map<std::string, RE::NiPointer<RE::NiNode>> nodes;    // lower-cased names
+            std::optional<std::vector<RE::NiPointer<BSGeometry>>> geometries;
+        };
+
+        std::mutex mutex;
+        std::unordered_map<RE::FormID, Entry> entries;
+
+        Entry& EntryForLocked(RE::FormID formID, RE::NiAVObject* root);
+
+        ActorNodeCache() = default;
+        ActorNodeCache(const ActorNodeCache&) = delete;
+        ActorNodeCache& operator=(const ActorNodeCache&) = delete;
     };
 
     struct Collision
     {
+        struct BatchStats
+        {
+            std::size_t roots = 0;
+            std::size_t worlds = 0;
+            std::size_t skipped = 0;    // refs without loaded 3D or a physics world
+            std::chrono::microseconds elapsed{ 0 };
+        };
+
         static bool ToggleMeshCollision(RE::NiAVObject* root, RE::bhkWorld* world, bool collisionState);
         static bool RemoveMeshCollision(RE::NiAVObject* root, RE::bhkWorld* world, bool collisionState);
+
+        // Groups refs by bhkWorld and takes each world lock once for all of its roots. Main thread only.
+        static BatchStats ToggleMeshCollision(std::span<RE::TESObjectREFR* const> refs, bool collisionState);
+
+    private:
+        // Caller must hold the world write lock
+        static void ApplyCollisionState(RE::NiAVObject* root, bool collisionState);
     };
 }
\ No newline at end of file
@@ -0,0 +1,488 @@
+#include "variables.h"
+#include "scheduler.h"
+#include "script.h"
+#include "triggergate.h"
+
+namespace SLT {
+
+#pragma region NameTable
+NameId NameTable::Intern(std::string_view name) {
+    std::string key = Util::String::ToLower(name);
+    {
+        std::shared_lock lock(mutex);
+        auto it = ids.find(key);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(mutex);
+    auto [it, inserted] = ids.try_emplace(std::move(key), static_cast<NameId>(names.size()));
+    if (inserted) {
+        names.emplace_back(name);
+    }
+    return it->second;
+}
+
+std::optional<NameId> NameTable::Find(std::string_view name) const {
+    std::shared_lock lock(mutex);
+    auto it = ids.find(Util::String::ToLower(name));
+    if (it == ids.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::string NameTable::GetName(NameId id) const {
+    std::shared_lock lock(mutex);
+    return id < names.size() ? names[id] : std::string{};
+}
+#pragma endregion
+
+#pragma region VariableStore
+namespace {
+constexpr std::uint16_t GENERATION_MASK = 0x7FFF;
+
+FrameHandle MakeHandle(std::size_t slot, std::uint16_t generation) {
+    return static_cast<FrameHandle>((static_cast<std::uint32_t>(generation & GENERATION_MASK) << 16) | static_cast<std::uint32_t>(slot + 1));
+}
+
+std::size_t HandleSlot(FrameHandle handle) {
+    return (static_cast<std::uint32_t>(handle) & 0xFFFF) - 1;
+}
+
+std::uint16_t HandleGeneration(FrameHandle handle) {
+    return static_cast<std::uint16_t>((static_cast<std::uint32_t>(handle) >> 16) & GENERATION_MASK);
+}
+
+void AppendU32(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+void AppendString(std::vector<std::uint8_t>& out, std::string_view str) {
+    AppendU32(out, static_cast<std::uint32_t>(str.size()));
+    out.insert(out.end(), str.begin(), str.end());
+}
+
+bool ReadString(SKSE::SerializationInterface* intfc, std::string& out) {
+    std::uint32_t length = 0;
+    if (!intfc->ReadRecordData(length)) {
+        return false;
+    }
+    out.resize(length);
+    return length == 0 || intfc->ReadRecordData(out.data(), length) == length;
+}
+
+bool ReadFrameValues(SKSE::SerializationInterface* intfc, VariableFrame& frame, std::uint32_t version) {
+    std::uint32_t count = 0;
+    if (!intfc->ReadRecordData(count)) {
+        return false;
+    }
+
+    auto& names = NameTable::GetSingleton();
+    std::string name;
+    std::string value;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        if (!ReadString(intfc, name) || !ReadString(intfc, value)) {
+            return false;
+        }
+        frame.values[names.Intern(name)] = value;
+    }
+
+    if (version < 2) {
+        return true;
+    }
+
+    std::uint32_t slotCount = 0;
+    if (!intfc->ReadRecordData(slotCount)) {
+        return false;
+    }
+    frame.slotNames.reserve(slotCount);
+    frame.slots.reserve(slotCount);
+    for (std::uint32_t i = 0; i < slotCount; ++i) {
+        std::uint8_t hasValue = 0;
+        if (!ReadString(intfc, name) || !intfc->ReadRecordData(hasValue)) {
+            return false;
+        }
+        frame.slotNames.push_back(names.Intern(name));
+        if (hasValue) {
+            if (!ReadString(intfc, value)) {
+                return false;
+            }
+            frame.slots.emplace_back(value);
+        } else {
+            frame.slots.emplace_back(std::nullopt);
+        }
+    }
+    return true;
+}
+}
+
+VariableFrame* VariableStore::ResolveFrame(FrameHandle handle) const {
+    if (handle <= 0) {
+        return nullptr;
+    }
+    std::size_t slot = HandleSlot(handle);
+    if (slot >= frames.size()) {
+        return nullptr;
+    }
+    auto* frame = frames[slot].get();
+    if (!frame->inUse || frame->generation != HandleGeneration(handle)) {
+        return nullptr;
+    }
+    return frame;
+}
+
+FrameHandle VariableStore::AllocateFrame() {
+    std::unique_lock lock(mutex);
+
+    std::size_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else if (frames.size() < kMaxFrames) {
+        slot = frames.size();
+        frames.push_back(std::make_unique<VariableFrame>());
+    } else {
+        logger::error("VariableStore: all {} variable frames are in use", kMaxFrames);
+        return 0;
+    }
+
+    auto& frame = *frames[slot];
+    frame.generation = static_cast<std::uint16_t>((frame.generation + 1) & GENERATION_MASK);
+    frame.inUse = true;
+    frame.dirty = true;
+    return MakeHandle(slot, frame.generation);
+}
+
+void VariableStore::ReleaseFrame(FrameHandle handle) {
+    std::unique_lock lock(mutex);
+    auto* frame = ResolveFrame(handle);
+    if (!frame) {
+        logger::warn("VariableStore: ReleaseFrame called with stale or invalid handle {}", handle);
+        return;
+    }
+    frame->Reset();
+    freeSlots.push_back(static_cast<std::uint16_t>(HandleSlot(handle)));
+}
+
+bool VariableStore::IsValidFrame(FrameHandle handle) const {
+    std::shared_lock lock(mutex);
+    return ResolveFrame(handle) != nullptr;
+}
+
+std::optional<std::string> VariableStore::GetFrameVar(FrameHandle handle, std::string_view name) const {
+    auto id = NameTable::GetSingleton().Find(name);
+    if (!id) {
+        return std::nullopt;
+    }
+
+    std::shared_lock lock(mutex);
+    auto* frame = ResolveFrame(handle);
+    if (!frame) {
+        return std::nullopt;
+    }
+    if (auto slot = frame->FindSlot(*id); slot >= 0) {
+        return frame->slots[slot];
+    }
+    auto it = frame->values.find(*id);
+    if (it == frame->values.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool VariableStore::SetFrameVar(FrameHandle handle, std::string_view name, std::string_view value) {
+    NameId id = NameTable::GetSingleton().Intern(name);
+
+    std::unique_lock lock(mutex);
+    auto* frame = ResolveFrame(handle);
+    if (!frame) {
+        logger::error("VariableStore: SetFrameVar({}) called with stale or invalid handle {}", name, handle);
+        return false;
+    }
+    if (auto slot = frame->FindSlot(id); slot >= 0) {
+        frame->slots[slot] = std::string(value);
+    } else {
+        frame->values[id] = value;
+    }
+    frame->dirty = true;
+    return true;
+}
+
+bool VariableStore::HasFrameVar(FrameHandle handle, std::string_view name) const {
+    auto id = NameTable::GetSingleton().Find(name);
+    if (!id) {
+        return false;
+    }
+
+    std::shared_lock lock(mutex);
+    auto* frame = ResolveFrame(handle);
+    if (!frame) {
+        return false;
+    }
+    if (auto slot = frame->FindSlot(*id); slot >= 0) {
+        return frame->slots[slot].has_value();
+    }
+    return frame->values.contains(*id);
+}
+
+std::int32_t VariableStore::BindFrame(FrameHandle handle, const std::vector<std::string>& slotNames) {
+    auto& names = NameTable::GetSingleton();
+    std::vector<NameId> ids;
+    ids.reserve(slotNames.size());
+    for (const auto& name : slotNames) {
+        ids.push_back(names.Intern(name));
+    }
+
+    std::unique_lock lock(mutex);
+    auto* frame = ResolveFrame(handle);
+    if (!frame) {
+        logger::error("VariableStore: BindFrame called with stale or invalid handle {}", handle);
+        return -1;
+    }
+
+    // Fold the previous layout back into by-name storage, then pull the new layout's names out of it
+    for (std::size_t i = 0; i < frame->slotNames.size(); ++i) {
+        if (frame->slots[i]) {
+            frame->values[frame->slotNames[i]] = std::move(*frame->slots[i]);
+        }
+    }
+
+    frame->slotNames = std::move(ids);
+    frame->slots.assign(frame->slotNames.size(), std::nullopt);
+    for (std::size_t i = 0; i < frame->slotNames.size(); ++i) {
+        auto node = frame->values.extract(frame->slotNames[i]);
+        if (!node.empty()) {
+            frame->slots[i] = std::move(node.mapped());
+        }
+    }
+    frame->dirty = true;
+    return static_cast<std::int32_t>(frame->slots.size());
+}
+
+std::optional<std::string> VariableStore::GetFrameSlot(FrameHandle handle, std::int32_t slot) const {
+    std::shared_lock lock(mutex);
+    auto* frame = ResolveFrame(handle);
+    if (!frame || slot < 0 || static_cast<std::size_t>(slot) >= frame->slots.size()) {
+        return std::nullopt;
+    }
+    return frame->slots[slot];
+}
+
+bool VariableStore::SetFrameSlot(FrameHandle handle, std::int32_t slot, std::string_view value) {
+    std::unique_lock lock(mutex);
+    auto* frame = ResolveFrame(handle);
+    if (!frame || slot < 0 || static_cast<std::size_t>(slot) >= frame->slots.size()) {
+        logger::error("VariableStore: SetFrameSlot({}) out of range or invalid handle {}", slot, handle);
+        return false;
+    }
+    frame->slots[slot] = std::string(value);
+    frame->dirty = true;
+    return true;
+}
+
+std::optional<std::string> VariableStore::GetGlobalVar(std::string_view name) const {
+    auto id = NameTable::GetSingleton().Find(name);
+    if (!id) {
+        return std::nullopt;
+    }
+
+    std::shared_lock lock(mutex);
+    auto it = globals.values.find(*id);
+    if (it == globals.values.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void VariableStore::SetGlobalVar(std::string_view name, std::string_view value) {
+    NameId id = NameTable::GetSingleton().Intern(name);
+
+    std::unique_lock lock(mutex);
+    globals.values[id] = value;
+    globals.dirty = true;
+}
+
+bool VariableStore::HasGlobalVar(std::string_view name) const {
+    auto id = NameTable::GetSingleton().Find(name);
+    if (!id) {
+        return false;
+    }
+
+    std::shared_lock lock(mutex);
+    return globals.values.contains(*id);
+}
+
+void VariableStore::Clear() {
+    std::unique_lock lock(mutex);
+    frames.clear();
+    freeSlots.clear();
+    globals.Reset();
+    globals.inUse = true;
+}
+
+void VariableStore::EncodeFrame(VariableFrame& frame) {
+    auto& names = NameTable::GetSingleton();
+    frame.encoded.clear();
+    AppendU32(frame.encoded, static_cast<std::uint32_t>(frame.values.size()));
+    for (const auto& [id, value] : frame.values) {
+        AppendString(frame.encoded, names.GetName(id));
+        AppendString(frame.encoded, value);
+    }
+    AppendU32(frame.encoded, static_cast<std::uint32_t>(frame.slotNames.size()));
+    for (std::size_t i = 0; i < frame.slotNames.size(); ++i) {
+        AppendString(frame.encoded, names.GetName(frame.slotNames[i]));
+        frame.encoded.push_back(frame.slots[i] ? 1 : 0);
+        if (frame.slots[i]) {
+            AppendString(frame.encoded, *frame.slots[i]);
+        }
+    }
+    frame.dirty = false;
+}
+
+void VariableStore::RegisterSerialization() {
+    auto* serialization = SKSE::GetSerializationInterface();
+    serialization->SetUniqueID(kSerializationId);
+    serialization->SetSaveCallback(OnSave);
+    serialization->SetLoadCallback(OnLoad);
+    serialization->SetRevertCallback(OnRevert);
+    globals.inUse = true;
+}
+
+void VariableStore::OnSave(SKSE::SerializationInterface* intfc) {
+    auto& store = GetSingleton();
+    std::unique_lock lock(store.mutex);
+
+    // Only frames touched since the last save are re-encoded; the rest reuse their cached bytes
+    std::size_t reencoded = 0;
+
+    if (store.globals.dirty || store.globals.encoded.empty()) {
+        EncodeFrame(store.globals);
+        reencoded++;
+    }
+    if (!intfc->OpenRecord(kGlobalsRecord, kRecordVersion) ||
+        !intfc->WriteRecordData(store.globals.encoded.data(), static_cast<std::uint32_t>(store.globals.encoded.size()))) {
+        logger::error("VariableStore: failed to write globals record");
+        return;
+    }
+
+    std::uint32_t liveFrames = 0;
+    for (const auto& frame : store.frames) {
+        if (frame->inUse) {
+            liveFrames++;
+        }
+    }
+
+    if (!intfc->OpenRecord(kFramesRecord, kRecordVersion) || !intfc->WriteRecordData(liveFrames)) {
+        logger::error("VariableStore: failed to write frames record");
+        return;
+    }
+
+    for (std::size_t slot = 0; slot < store.frames.size(); ++slot) {
+        auto& frame = *store.frames[slot];
+        if (!frame.inUse) {
+            continue;
+        }
+        if (frame.dirty || frame.encoded.empty()) {
+            EncodeFrame(frame);
+            reencoded++;
+        }
+        FrameHandle handle = MakeHandle(slot, frame.generation);
+        if (!intfc->WriteRecordData(handle) ||
+            !intfc->WriteRecordData(frame.encoded.data(), static_cast<std::uint32_t>(frame.encoded.size()))) {
+            logger::error("VariableStore: failed to write frame {}", handle);
+            return;
+        }
+    }
+
+    logger::info("VariableStore: saved {} frames ({} re-encoded)", liveFrames, reencoded);
+
+    // the plugin has a single cosave id, so the trigger gate's, script handles' and waits' records ride along here
+    lock.unlock();
+    TriggerGate::GetSingleton().Save(intfc);
+    ScriptHandleTable::GetSingleton().Save(intfc);
+    WaitScheduler::GetSingleton().Save(intfc);
+}
+
+void VariableStore::OnLoad(SKSE::SerializationInterface* intfc) {
+    auto& store = GetSingleton();
+    store.Clear();
+
+    std::unique_lock lock(store.mutex);
+
+    std::uint32_t type;
+    std::uint32_t version;
+    std::uint32_t length;
+    while (intfc->GetNextRecordInfo(type, version, length)) {
+        if (type == TriggerGate::kRecord) {
+            TriggerGate::GetSingleton().Load(intfc, version);
+            continue;
+        }
+        if (type == ScriptHandleTable::kRecord) {
+            ScriptHandleTable::GetSingleton().Load(intfc, version);
+            continue;
+        }
+        if (type == WaitScheduler::kRecord) {
+            WaitScheduler::GetSingleton().Load(intfc, version);
+            continue;
+        }
+        if (version < 1 || version > kRecordVersion) {
+            logger::error("VariableStore: unsupported record version {} for record {:08X}", version, type);
+            continue;
+        }
+
+        switch (type) {
+            case kGlobalsRecord:
+                if (!ReadFrameValues(intfc, store.globals, version)) {
+                    logger::error("VariableStore: failed to read globals record");
+                }
+                break;
+            case kFramesRecord: {
+                std::uint32_t count = 0;
+                intfc->ReadRecordData(count);
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    FrameHandle handle = 0;
+                    if (!intfc->ReadRecordData(handle) || handle <= 0) {
+                        logger::error("VariableStore: failed to read frame header");
+                        break;
+                    }
+
+                    std::size_t slot = HandleSlot(handle);
+                    while (store.frames.size() <= slot) {
+                        store.frames.push_back(std::make_unique<VariableFrame>());
+                    }
+
+                    auto& frame = *store.frames[slot];
+                    frame.generation = HandleGeneration(handle);
+                    frame.inUse = true;
+                    if (!ReadFrameValues(intfc, frame, version)) {
+                        logger::error("VariableStore: failed to read frame {}", handle);
+                        break;
+                    }
+                    frame.dirty = true;
+                }
+                break;
+            }
+            default:
+                logger::warn("VariableStore: unrecognized record {:08X}", type);
+                break;
+        }
+    }
+
+    for (std::size_t slot = 0; slot < store.frames.size(); ++slot) {
+        if (!store.frames[slot]->inUse) {
+            store.freeSlots.push_back(static_cast<std::uint16_t>(slot));
+        }
+    }
+    store.globals.dirty = true;
+}
+
+void VariableStore::OnRevert(SKSE::SerializationInterface*) {
+    GetSingleton().Clear();
+    TriggerGate::GetSingleton().Clear();
+    ScriptHandleTable::GetSingleton().Clear();
+}
+#pragma endregion
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+namespace SLT {
+
+#pragma region NameTable
+typedef std::uint32_t NameId;
+
+// Case-insensitive interning of variable names so frames can key on a small integer
+class NameTable {
+public:
+    static NameTable& GetSingleton() {
+        static NameTable singleton;
+        return singleton;
+    }
+
+    NameId Intern(std::string_view name);
+    std::optional<NameId> Find(std::string_view name) const;
+    std::string GetName(NameId id) const;
+
+private:
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, NameId> ids; // lowercased name -> id
+    std::vector<std::string> names;              // id -> name as first interned
+
+    NameTable() = default;
+    NameTable(const NameTable&) = delete;
+    NameTable& operator=(const NameTable&) = delete;
+};
+#pragma endregion
+
+#pragma region VariableFrame
+struct VariableFrame {
+    std::unordered_map<NameId, std::string> values;     // names without a slot in the bound script
+    std::vector<NameId> slotNames;                      // slot layout bound from the running script
+    std::vector<std::optional<std::string>> slots;
+    std::vector<std::uint8_t> encoded; // cosave bytes from the last save; rebuilt only when dirty
+    std::uint16_t generation = 0;
+    bool inUse = false;
+    bool dirty = false;
+
+    // Returns the slot holding a name, or -1 if the name is stored by name
+    std::int32_t FindSlot(NameId id) const {
+        auto it = std::find(slotNames.begin(), slotNames.end(), id);
+        return it != slotNames.end() ? static_cast<std::int32_t>(std::distance(slotNames.begin(), it)) : -1;
+    }
+
+    void Reset() {
+        values.clear(); // keeps bucket storage for the next script using this frame
+        slotNames.clear();
+        slots.clear();
+        encoded.clear();
+        inUse = false;
+        dirty = false;
+    }
+};
+#pragma endregion
+
+#pragma region VariableStore
+// Native home for SLT script variables: one frame per running script instance plus a global
+// scope. Frames are pooled and addressed by a handle that encodes the pool slot and a
+// generation, so a handle held by a finished script can never reach a recycled frame.
+class VariableStore {
+public:
+    static constexpr std::uint32_t kSerializationId = 'SLTV';
+    static constexpr std::uint32_t kGlobalsRecord = 'GLOB';
+    static constexpr std::uint32_t kFramesRecord = 'FRMS';
+    static constexpr std::uint32_t kRecordVersion = 2; // 2: frames carry their slot layout
+
+    static VariableStore& GetSingleton() {
+        static VariableStore singleton;
+        return singleton;
+    }
+
+    FrameHandle AllocateFrame();
+    void ReleaseFrame(FrameHandle handle);
+    bool IsValidFrame(FrameHandle handle) const;
+
+    std::optional<std::string> GetFrameVar(FrameHandle handle, std::string_view name) const;
+    bool SetFrameVar(FrameHandle handle, std::string_view name, std::string_view value);
+    bool HasFrameVar(FrameHandle handle, std::string_view name) const;
+
+    // Binds a frame to a script's slot layout, moving any same-named values into their slots.
+    // Returns the slot count, or -1 for an invalid handle.
+    std::int32_t BindFrame(FrameHandle handle, const std::vector<std::string>& slotNames);
+    std::optional<std::string> GetFrameSlot(FrameHandle handle, std::int32_t slot) const;
+    bool SetFrameSlot(FrameHandle handle, std::int32_t slot, std::string_view value);
+
+    std::optional<std::string> GetGlobalVar(std::string_view name) const;
+    void SetGlobalVar(std::string_view name, std::string_view value);
+    bool HasGlobalVar(std::string_view name) const;
+
+    void Clear();
+
+    void RegisterSerialization();
+
+private:
+    static constexpr std::size_t kMaxFrames = 0xFFFF;
+
+    mutable std::shared_mutex mutex;
+    std::vector<std::unique_ptr<VariableFrame>> frames;
+    std::vector<std::uint16_t> freeSlots;
+    VariableFrame globals;
+
+    VariableFrame* ResolveFrame(FrameHandle handle) const;
+
+    static void EncodeFrame(VariableFrame& frame);
+    static void OnSave(SKSE::SerializationInterface* intfc);
+    static void OnLoad(SKSE::SerializationInterface* intfc);
+    static void OnRevert(SKSE::SerializationInterface* intfc);
+
+    VariableStore() = default;
+    VariableStore(const VariableStore&) = delete;
+    VariableStore& operator=(const VariableStore&) = delete;
+};
+#pragma endregion
+}
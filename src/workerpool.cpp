@@ -0,0 +1,74 @@
+#include "workerpool.h"
+
+namespace SLT {
+
+#pragma region WorkerPool
+void WorkerPool::Submit(Job job, Priority priority) {
+    if (!job) {
+        return;
+    }
+    {
+        std::lock_guard lock(mutex);
+        if (priority == Priority::Low) {
+            lowJobs.push_back(std::move(job));
+        } else {
+            normalJobs.push_back(std::move(job));
+        }
+        StartWorkersLocked();
+    }
+    wakeup.notify_one();
+}
+
+std::size_t WorkerPool::PendingCount() const {
+    std::lock_guard lock(mutex);
+    return normalJobs.size() + lowJobs.size();
+}
+
+void WorkerPool::StartWorkersLocked() {
+    if (!workers.empty()) {
+        return;
+    }
+    std::size_t count = std::clamp<std::size_t>(std::thread::hardware_concurrency() / 4, 1, kMaxWorkers);
+    for (std::size_t i = 0; i < count; ++i) {
+        workers.emplace_back([this]() { WorkerLoop(); });
+    }
+    logger::info("WorkerPool: started {} worker threads", count);
+}
+
+void WorkerPool::WorkerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex);
+            wakeup.wait(lock, [this]() { return stopping || !normalJobs.empty() || !lowJobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            auto& queue = !normalJobs.empty() ? normalJobs : lowJobs;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        try {
+            job();
+        } catch (const std::exception& e) {
+            logger::error("WorkerPool: job failed: {}", e.what());
+        } catch (...) {
+            logger::error("WorkerPool: job failed with an unknown exception");
+        }
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wakeup.notify_all();
+    // not joined: this runs during DLL teardown, where waiting on threads can deadlock
+    for (auto& worker : workers) {
+        worker.detach();
+    }
+}
+#pragma endregion
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "taskqueue.h"
+
+namespace SLT {
+
+#pragma region WorkerPool
+// A few background threads for blocking work (filesystem, parsing) that should not run on a
+// Papyrus VM thread. Threads start on first use. Low priority jobs only run when no normal
+// priority job is waiting.
+class WorkerPool {
+public:
+    enum class Priority : std::uint8_t {
+        Normal,
+        Low
+    };
+
+    using Job = std::function<void()>;
+
+    static constexpr std::size_t kMaxWorkers = 2;
+
+    static WorkerPool& GetSingleton() {
+        static WorkerPool singleton;
+        return singleton;
+    }
+
+    void Submit(Job job, Priority priority = Priority::Normal);
+
+    std::size_t PendingCount() const;
+
+private:
+    mutable std::mutex mutex;
+    std::condition_variable wakeup;
+    std::deque<Job> normalJobs;
+    std::deque<Job> lowJobs;
+    std::vector<std::thread> workers;
+    bool stopping = false;
+
+    void StartWorkersLocked();
+    void WorkerLoop();
+
+    WorkerPool() = default;
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+};
+#pragma endregion
+
+#pragma region Latent helpers
+// Runs job on the worker pool and hands its result back to the waiting Papyrus stack from the
+// main thread. Anything job captures must be owned (no string_views into VM memory). A job
+// that throws returns a default-constructed result, so the waiting stack is always released.
+template <class Job>
+RE::BSScript::LatentStatus ReturnLatentFromWorker(RE::BSScript::Internal::VirtualMachine* vm, RE::VMStackID stackId, Job job) {
+    WorkerPool::GetSingleton().Submit([vm, stackId, job = std::move(job)]() mutable {
+        std::invoke_result_t<Job&> result{};
+        try {
+            result = job();
+        } catch (const std::exception& e) {
+            logger::error("Latent native failed on a worker thread: {}", e.what());
+        } catch (...) {
+            logger::error("Latent native failed on a worker thread: unknown exception");
+        }
+        MainThreadQueue::GetSingleton().Enqueue([vm, stackId, result = std::move(result)]() mutable {
+            vm->ReturnLatentResult(stackId, std::move(result));
+        }, MainThreadQueue::Priority::High);
+    });
+    return RE::BSScript::LatentStatus::kStarted;
+}
+#pragma endregion
+}
@@ -0,0 +1,98 @@
+// Checks MathUtil::Batch against the scalar Angle functions it replaces, over random points
+// and the edge cases of the SSE atan2 (coincident points, axis-aligned and near-axis offsets),
+// at sizes that exercise both the four-wide loop and the scalar tail.
+
+#include <cstdio>
+#include <random>
+
+namespace {
+constexpr double kAngleTolerance = 1e-6;    // radians; the SSE atan2 is good to ~2e-7
+constexpr double kRelativeTolerance = 1e-6; // distances and rotated components
+
+int failures = 0;
+
+void Check(bool ok, std::string_view what, std::size_t count, std::size_t index, double error) {
+    if (!ok) {
+        failures++;
+        std::printf("FAIL %.*s: n=%zu i=%zu error=%.3g\n", static_cast<int>(what.size()), what.data(), count, index, error);
+    }
+}
+
+double Relative(double expected, double actual) {
+    return std::fabs(expected - actual) / std::max(1.0, std::fabs(expected));
+}
+
+MathUtil::Batch::Points MakePoints(std::mt19937& rng, const RE::NiPoint3& from, std::size_t count) {
+    std::uniform_real_distribution<float> coord(-5000.0f, 5000.0f);
+    MathUtil::Batch::Points points;
+    for (std::size_t i = 0; i < count; ++i) {
+        points.push_back({ coord(rng), coord(rng), coord(rng) });
+    }
+
+    const RE::NiPoint3 edges[] = {
+        from,                                  // coincident: both atan2 arguments zero
+        { from.x, from.y + 1.0f, from.z },     // straight ahead
+        { from.x - 1.0f, from.y, from.z },     // straight left
+        { from.x, from.y - 1.0f, from.z },     // behind, on the branch cut
+        { from.x - 1.0f, from.y - 1e-3f, from.z + 1.0f },
+        { from.x, from.y, from.z - 10.0f },    // straight down
+    };
+    for (std::size_t i = 0; i < std::size(edges) && i < count; ++i) {
+        points.x[i] = edges[i].x;
+        points.y[i] = edges[i].y;
+        points.z[i] = edges[i].z;
+    }
+    return points;
+}
+
+void CheckAngles(std::mt19937& rng, std::size_t count) {
+    const RE::NiPoint3 from{ 12.5f, -300.0f, 64.0f };
+    const auto points = MakePoints(rng, from, count);
+
+    std::vector<float> angleZ(count), angleX(count), distance(count);
+    MathUtil::Batch::GetAngles(from, points, angleZ, angleX, distance);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        MathUtil::Angle::AngleZX expected{};
+        MathUtil::Angle::GetAngle(from, { points.x[i], points.y[i], points.z[i] }, expected);
+
+        const double errorZ = std::fabs(expected.z - angleZ[i]);
+        const double errorX = std::fabs(expected.x - angleX[i]);
+        const double errorD = Relative(expected.distance, distance[i]);
+        Check(errorZ <= kAngleTolerance, "GetAngles z", count, i, errorZ);
+        Check(errorX <= kAngleTolerance, "GetAngles x", count, i, errorX);
+        Check(errorD <= kRelativeTolerance, "GetAngles distance", count, i, errorD);
+    }
+}
+
+void CheckRotations(std::mt19937& rng, std::size_t count) {
+    const auto points = MakePoints(rng, {}, count);
+    const RE::NiQuaternion quat{ 0.8f, 0.2f, -0.3f, 0.4f };
+
+    MathUtil::Batch::Points rotated;
+    MathUtil::Batch::RotateVectors(points, quat, rotated);
+    Check(rotated.size() == count, "RotateVectors size", count, 0, static_cast<double>(rotated.size()));
+
+    for (std::size_t i = 0; i < count && i < rotated.size(); ++i) {
+        const auto expected = MathUtil::Angle::RotateVector({ points.x[i], points.y[i], points.z[i] }, quat);
+        const double error = std::max({ Relative(expected.x, rotated.x[i]), Relative(expected.y, rotated.y[i]),
+                                        Relative(expected.z, rotated.z[i]) });
+        Check(error <= kRelativeTolerance, "RotateVectors", count, i, error);
+    }
+}
+}
+
+int main() {
+    std::mt19937 rng(1);
+    for (std::size_t count : { 0, 1, 3, 4, 7, 8, 1001 }) {
+        CheckAngles(rng, count);
+        CheckRotations(rng, count);
+    }
+
+    if (failures > 0) {
+        std::printf("%d batch accuracy checks failed\n", failures);
+        return 1;
+    }
+    std::printf("batch accuracy: ok\n");
+    return 0;
+}
@@ -0,0 +1,133 @@
+// Checks CompiledExpression against the natives and rules the Papyrus side uses: '==' and '!='
+// against SmartEquals for literal and variable operands, the text results are stored as, and
+// each documented divergence (see CompiledExpression), so a change to any of them is noticed.
+// Also checks that ExpressionCache stays within its bound.
+
+#include "expression.h"
+#include "sl_triggers.h"
+
+#include <cstdio>
+
+namespace {
+using namespace SLT;
+
+int failures = 0;
+
+void Check(bool ok, std::string_view what, std::string_view detail) {
+    if (!ok) {
+        failures++;
+        std::printf("FAIL %.*s: %.*s\n", static_cast<int>(what.size()), what.data(), static_cast<int>(detail.size()), detail.data());
+    }
+}
+
+// Evaluates tokens with $a and $b bound to the given text, as a script variable would hold it
+std::string Evaluate(const std::vector<std::string>& tokens, std::string_view a = {}, std::string_view b = {}) {
+    std::string error;
+    auto compiled = CompiledExpression::Compile(tokens, error);
+    if (!compiled) {
+        return "<" + error + ">";
+    }
+    return ExprValueToString(compiled->Evaluate([a, b](std::string_view name) -> ExprValue {
+        return ExprValueFromText(name == "a" ? a : b);
+    }));
+}
+
+std::string Quote(std::string_view text) {
+    return std::format("\"{}\"", text);
+}
+
+void CheckEquality() {
+    // both written as quoted literals, as bare literals where they tokenize as one, and as variables
+    const std::pair<std::string_view, std::string_view> pairs[] = {
+        { "abc", "abc" }, { "abc", "ABC" }, { "", "" }, { "", "0" }, { "0", "false" }, { "", "false" },
+        { "1", "1.0" }, { "1", "1.000000" }, { "0x10", "16" }, { "0x10", "0x10" }, { "05", "5" },
+        { "1e3", "1000" }, { "1.1", "1.1000001" }, { "0.1", "0.10000001" }, { "16777217", "16777216" },
+        { "true", "True" }, { "-0", "0" }, { "inf", "inf" }, { "7", "7 " }, { "1.5", "1.5abc" },
+    };
+
+    for (const auto& [a, b] : pairs) {
+        const bool expected = SLTNativeFunctions::SmartEquals(nullptr, 0, a, b);
+        const std::string want = ExprValueToString(expected);
+        const std::string wantNot = ExprValueToString(!expected);
+        const std::string detail = std::format("'{}' vs '{}'", a, b);
+
+        Check(Evaluate({ Quote(a), "==", Quote(b) }) == want, "quoted ==", detail);
+        Check(Evaluate({ Quote(a), "!=", Quote(b) }) == wantNot, "quoted !=", detail);
+        Check(Evaluate({ "$a", "==", "$b" }, a, b) == want, "variable ==", detail);
+        Check(Evaluate({ "$a", "!=", "$b" }, a, b) == wantNot, "variable !=", detail);
+        if (!a.empty() && !b.empty() && a.find(' ') == std::string_view::npos && b.find(' ') == std::string_view::npos) {
+            Check(Evaluate({ std::string(a), "=", std::string(b) }) == want, "bare =", detail);
+        }
+    }
+}
+
+void CheckText() {
+    // operands read back exactly as written
+    Check(Evaluate({ "0x10" }) == "0x10", "hex literal", Evaluate({ "0x10" }));
+    Check(Evaluate({ "$a" }, "1.5") == "1.5", "float variable", Evaluate({ "$a" }, "1.5"));
+    Check(Evaluate({ "$a", "&", "1.5" }, "x") == "x1.5", "concatenation", Evaluate({ "$a", "&", "1.5" }, "x"));
+
+    // results as Papyrus prints them
+    Check(Evaluate({ "1", "<", "2" }) == "True", "bool text", Evaluate({ "1", "<", "2" }));
+    Check(Evaluate({ "1.5", "*", "2" }) == "3.000000", "float text", Evaluate({ "1.5", "*", "2" }));
+    Check(Evaluate({ "2", "*", "3" }) == "6", "int text", Evaluate({ "2", "*", "3" }));
+}
+
+void CheckDivergences() {
+    // ints divide as ints and wrap, where the Papyrus side works in floats
+    Check(Evaluate({ "7", "/", "2" }) == "3", "int division", Evaluate({ "7", "/", "2" }));
+    Check(Evaluate({ "7.0", "/", "2" }) == "3.500000", "float division", Evaluate({ "7.0", "/", "2" }));
+    Check(Evaluate({ "2147483647", "+", "1" }) == "-2147483648", "int wrap", Evaluate({ "2147483647", "+", "1" }));
+    Check(Evaluate({ "0x10", "+", "1" }) == "17", "hex arithmetic", Evaluate({ "0x10", "+", "1" }));
+
+    // ordering reads numbers as SmartEquals does: hex and other text are 0
+    Check(Evaluate({ "0x10", ">", "5" }) == "False", "hex ordering", Evaluate({ "0x10", ">", "5" }));
+    Check(Evaluate({ "\"abc\"", "<", "1" }) == "True", "text ordering", Evaluate({ "\"abc\"", "<", "1" }));
+    Check(Evaluate({ "16777217", ">", "16777216" }) == "False", "float ordering", Evaluate({ "16777217", ">", "16777216" }));
+
+    // truthiness is SmartComparator's, on the text as written
+    Check(Evaluate({ "!", "$a" }, "0") == "True", "truthy 0", "");
+    Check(Evaluate({ "!", "$a" }, "FALSE") == "True", "truthy FALSE", "");
+    Check(Evaluate({ "!", "$a" }, "0.0") == "False", "truthy 0.0", "");
+    Check(Evaluate({ "!", "$a" }, "False") == "True", "truthy False", "");
+}
+
+void CheckCacheBound() {
+    auto& cache = ExpressionCache::GetSingleton();
+    cache.Clear();
+
+    const std::vector<std::string> tokens = { "$a", "+", "1" };
+    const std::int32_t linesPerScript = 1000;
+    for (std::int32_t script = 0; script < 40; ++script) {
+        const auto name = std::format("bound{}.sltscript", script);
+        for (std::int32_t line = 1; line <= linesPerScript; ++line) {
+            cache.GetOrCompile(name, line, tokens);
+        }
+        Check(cache.Size() <= ExpressionCache::kMaxEntries, "cache bound", std::format("{} entries", cache.Size()));
+    }
+
+    // the script being compiled into is never the one evicted
+    Check(cache.Size() >= linesPerScript, "cache keeps current script", std::format("{} entries", cache.Size()));
+
+    cache.Invalidate("bound39.sltscript");
+    cache.Clear();
+    Check(cache.Size() == 0, "cache clear", std::format("{} entries", cache.Size()));
+}
+}
+
+int main() {
+    // failed compiles and evictions would only add noise
+    spdlog::set_level(spdlog::level::off);
+
+    CheckEquality();
+    CheckText();
+    CheckDivergences();
+    CheckCacheBound();
+
+    if (failures > 0) {
+        std::printf("%d expression semantics checks failed\n", failures);
+        return 1;
+    }
+    std::printf("expression semantics: ok\n");
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "fakepapyrusvm.h"
+
+namespace SLT {
+
+#pragma region FakePapyrusVM
+void FakePapyrusVM::DefineScript(std::string_view scriptName, std::vector<std::string> operations) {
+    std::lock_guard lock(mutex);
+    scripts[str::ToLower(scriptName)] = std::move(operations);
+}
+
+void FakePapyrusVM::DefineSpellEffects(std::span<const RE::FormID> spells, std::span<const RE::FormID> effects) {
+    std::lock_guard lock(mutex);
+    for (std::size_t i = 0; i < spells.size() && i < effects.size(); ++i) {
+        spellEffects[spells[i]] = effects[i];
+    }
+}
+
+std::size_t FakePapyrusVM::Advance(float seconds) {
+    std::vector<ResultCallback> due;
+    {
+        std::lock_guard lock(mutex);
+        now += std::max(seconds, 0.0f);
+        while (!pending.empty() && pending.front().due <= now) {
+            stats.completed++;
+            stats.totalLatencySeconds += now - pending.front().issued;
+            due.push_back(std::move(pending.front().callback));
+            pending.pop_front();
+        }
+        for (auto it = occupied.begin(); it != occupied.end();) {
+            occupiedCount -= std::erase_if(it->second, [this](const auto& entry) { return entry.second <= now; });
+            it = it->second.empty() ? occupied.erase(it) : std::next(it);
+        }
+    }
+
+    for (auto& callback : due) {
+        if (callback) {
+            callback(std::string());
+        }
+    }
+    return due.size();
+}
+
+FakePapyrusVM::Stats FakePapyrusVM::GetStats() const {
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+bool FakePapyrusVM::DispatchStaticCall(std::string_view className, std::string_view functionName, RE::FormID,
+                                       std::uint16_t, std::vector<Argument>, ResultCallback callback) {
+    std::lock_guard lock(mutex);
+    auto it = scripts.find(str::ToLower(className));
+    if (it == scripts.end() || std::ranges::none_of(it->second, [functionName](const std::string& operation) {
+            return str::iEquals(operation, functionName);
+        })) {
+        stats.rejected++;
+        return false;
+    }
+
+    stats.dispatched++;
+    pending.push_back({ now + settings.dispatchLatencySeconds, now, std::move(callback) });
+    stats.peakPending = std::max<std::uint64_t>(stats.peakPending, pending.size());
+    return true;
+}
+
+bool FakePapyrusVM::GetOperationFunctions(std::string_view scriptName, std::vector<std::string>& operations) {
+    std::lock_guard lock(mutex);
+    auto it = scripts.find(str::ToLower(scriptName));
+    if (it == scripts.end()) {
+        return false;
+    }
+    operations.insert(operations.end(), it->second.begin(), it->second.end());
+    return true;
+}
+
+bool FakePapyrusVM::GetMagicEffects(RE::FormID target, std::vector<RE::FormID>& effects) {
+    if (target == 0) {
+        return false;
+    }
+    std::lock_guard lock(mutex);
+    if (auto it = occupied.find(target); it != occupied.end()) {
+        for (const auto& [effect, expiry] : it->second) {
+            if (expiry > now) {
+                effects.push_back(effect);
+            }
+        }
+    }
+    return true;
+}
+
+bool FakePapyrusVM::HasActiveEffect(RE::FormID target, std::uint16_t) {
+    return target != 0;
+}
+
+bool FakePapyrusVM::CastSpell(RE::FormID target, RE::FormID spell) {
+    if (target == 0) {
+        return false;
+    }
+    std::lock_guard lock(mutex);
+    stats.casts++;
+    if (auto it = spellEffects.find(spell); it != spellEffects.end() && it->second != 0) {
+        auto [entry, inserted] = occupied[target].insert_or_assign(it->second, now + settings.effectSeconds);
+        if (inserted) {
+            occupiedCount++;
+        }
+        stats.peakOccupied = std::max<std::uint64_t>(stats.peakOccupied, occupiedCount);
+    }
+    return true;
+}
+#pragma endregion
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+namespace SLT {
+
+#pragma region FakePapyrusVM
+// A stand-in for running the native layers outside the game. Script types and their operations
+// are declared up front; a dispatch completes, with an empty result, once the simulated clock
+// has moved past its latency; a cast occupies (target, effect) for the configured effect
+// duration. The clock only moves when Advance() is called, so a harness controls timing fully.
+// Any nonzero form id is taken to be an actor that can hold magic effects. Active effects are
+// tracked by base effect only, so any effect unique id counts as held by any such actor.
+class FakePapyrusVM : public PapyrusVM {
+public:
+    struct Settings {
+        float dispatchLatencySeconds = 0.0f;
+        float effectSeconds = 1.0f;
+    };
+
+    struct Stats {
+        std::uint64_t dispatched;
+        std::uint64_t completed;
+        std::uint64_t rejected;      // dispatches to an unknown script or function
+        std::uint64_t casts;
+        std::uint64_t peakPending;
+        std::uint64_t peakOccupied;
+        double totalLatencySeconds;  // simulated, summed over completed dispatches
+    };
+
+    explicit FakePapyrusVM(const Settings& settings) : settings(settings) {}
+
+    void DefineScript(std::string_view scriptName, std::vector<std::string> operations);
+
+    // Pairs pool spells with the effect each one applies, index for index
+    void DefineSpellEffects(std::span<const RE::FormID> spells, std::span<const RE::FormID> effects);
+
+    // Moves the simulated clock, completes due dispatches and expires due effects; returns the
+    // number of dispatches completed. Callbacks run on the calling thread, outside the lock.
+    std::size_t Advance(float seconds);
+
+    Stats GetStats() const;
+
+    bool DispatchStaticCall(std::string_view className, std::string_view functionName, RE::FormID target,
+                            std::uint16_t effectId, std::vector<Argument> args, ResultCallback callback) override;
+    bool GetOperationFunctions(std::string_view scriptName, std::vector<std::string>& operations) override;
+    bool GetMagicEffects(RE::FormID target, std::vector<RE::FormID>& effects) override;
+    bool HasActiveEffect(RE::FormID target, std::uint16_t effectId) override;
+    bool CastSpell(RE::FormID target, RE::FormID spell) override;
+
+private:
+    struct PendingCall {
+        double due;
+        double issued;
+        ResultCallback callback;
+    };
+
+    const Settings settings;
+
+    mutable std::mutex mutex;
+    double now = 0.0;
+    std::unordered_map<std::string, std::vector<std::string>> scripts; // by lowercased name
+    std::unordered_map<RE::FormID, RE::FormID> spellEffects;
+    std::deque<PendingCall> pending; // issued in order with a fixed latency, so also due in order
+    std::unordered_map<RE::FormID, std::unordered_map<RE::FormID, double>> occupied; // target -> effect -> expiry
+    std::size_t occupiedCount = 0;
+    Stats stats{};
+};
+#pragma endregion
+}
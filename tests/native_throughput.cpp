@@ -0,0 +1,201 @@
+// Drives the native layers through their form-id entry points against a FakePapyrusVM and
+// reports throughput and latency for each: ScriptPoolManager::ApplyScriptBatch, direct
+// OperationRunner dispatches and ScriptContextManager contexts running a dispatch loop. The
+// simulated clock advances in 60 Hz frames, each draining the fake VM, the WaitScheduler and the
+// MainThreadQueue as the main-loop hook would. Wall times are for the native side only; the
+// simulated latencies are what a script would wait with the configured dispatch latency.
+//
+//   native_throughput [targets] [operations per context]
+//
+// Exits nonzero if any batch slot, dispatch or context goes missing, so it also runs as a test.
+
+#include "fakepapyrusvm.h"
+#include "scriptcontext.h"
+#include "sl_triggers.h"
+#include "taskqueue.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+using namespace SLT;
+using Clock = std::chrono::steady_clock;
+
+constexpr float kFrameSeconds = 1.0f / 60.0f;
+constexpr std::string_view kLibrary = "sl_triggersCmdLibSLT";
+constexpr RE::FormID kFirstTarget = 0xFF000800;
+constexpr std::size_t kPoolSize = 16;
+
+int failures = 0;
+
+void Check(bool ok, std::string_view what, std::uint64_t expected, std::uint64_t actual) {
+    if (!ok) {
+        failures++;
+        std::printf("FAIL %.*s: expected %llu, got %llu\n", static_cast<int>(what.size()), what.data(),
+                    static_cast<unsigned long long>(expected), static_cast<unsigned long long>(actual));
+    }
+}
+
+double Micros(Clock::duration elapsed) {
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+// One simulated frame: completes due dispatches, then runs what the main-loop hook would
+void Frame(FakePapyrusVM& vm) {
+    vm.Advance(kFrameSeconds);
+    WaitScheduler::GetSingleton().Drain(kFrameSeconds, false);
+    MainThreadQueue::GetSingleton().RunFrame();
+}
+
+// A loop of dispatches, built the way ScriptLibrary lays a loaded script out but without the
+// pooled literals, which would need the game's string cache
+std::shared_ptr<const LoadedScript> MakeLoopScript(std::int32_t operations) {
+    auto script = std::make_shared<LoadedScript>();
+    script->name = "native_throughput.sltscript";
+    const std::string source[] = {
+        "set $i 0",
+        std::format("while $i < {}", operations),
+        "op_a $i \"literal\"",
+        "set $i $i + 1",
+        "endwhile",
+    };
+    std::int32_t lineNo = 0;
+    for (const auto& text : source) {
+        auto& line = script->lines.emplace_back();
+        line.lineNo = ++lineNo;
+        line.tokens = SLTNativeFunctions::Tokenizev2(nullptr, 0, text);
+        line.slots.assign(line.tokens.size(), NO_SLOT);
+        line.literals.assign(line.tokens.size(), nullptr);
+    }
+    ScriptLibrary::BuildControlFlow(*script);
+    return script;
+}
+
+void RunBatch(FakePapyrusVM& vm, std::span<const RE::FormID> targets) {
+    auto& pool = ScriptPoolManager::GetSingleton();
+    const auto castsBefore = vm.GetStats().casts;
+
+    // every target takes each pool slot once, so the last round must fill the pool
+    std::uint64_t queued = 0;
+    const auto start = Clock::now();
+    for (std::size_t round = 0; round < kPoolSize; ++round) {
+        for (auto code : pool.ApplyScriptBatch(targets, "native_throughput.sltscript")) {
+            queued += code == ScriptPoolManager::kBatchQueued;
+        }
+        Frame(vm);
+    }
+    const auto elapsed = Clock::now() - start;
+
+    auto full = pool.ApplyScriptBatch(targets, "native_throughput.sltscript");
+    const auto noSlot = static_cast<std::uint64_t>(std::ranges::count(full, ScriptPoolManager::kBatchNoFreeSlot));
+    Check(queued == targets.size() * kPoolSize, "batch slots queued", targets.size() * kPoolSize, queued);
+    Check(vm.GetStats().casts - castsBefore == queued, "batch casts", queued, vm.GetStats().casts - castsBefore);
+    Check(noSlot == targets.size(), "batch pool full", targets.size(), noSlot);
+
+    std::printf("ApplyScriptBatch:   %zu targets x %zu rounds, %.2f us per target, casts included\n", targets.size(), kPoolSize,
+                Micros(elapsed) / static_cast<double>(queued ? queued : 1));
+}
+
+void RunDispatches(FakePapyrusVM& vm, std::span<const RE::FormID> targets, std::int32_t perTarget) {
+    const auto before = vm.GetStats();
+    std::uint64_t completed = 0;
+    std::uint64_t issued = 0;
+
+    const auto start = Clock::now();
+    for (std::int32_t i = 0; i < perTarget; ++i) {
+        for (auto target : targets) {
+            std::vector<PapyrusVM::Argument> args;
+            args.push_back({ "op_a", true });
+            args.push_back({ std::to_string(i), false });
+            issued += OperationRunner::RunOperationOnActor(target, 1, std::move(args), [&completed](std::string) { completed++; });
+        }
+    }
+    const auto elapsed = Clock::now() - start;
+
+    for (std::int32_t frame = 0; frame < 600 && completed < issued; ++frame) {
+        Frame(vm);
+    }
+
+    const auto after = vm.GetStats();
+    const auto expected = targets.size() * static_cast<std::uint64_t>(perTarget);
+    Check(issued == expected, "dispatches issued", expected, issued);
+    Check(completed == issued, "dispatches completed", issued, completed);
+    Check(!OperationRunner::RunOperationOnActor(targets[0], 1, { { "no_such_op", true } }), "unknown operation rejected", 0, 1);
+
+    const auto done = after.completed - before.completed;
+    std::printf("RunOperationOnActor: %llu dispatches, %.3f us each, %.1f ms simulated latency\n",
+                static_cast<unsigned long long>(issued), Micros(elapsed) / static_cast<double>(issued ? issued : 1),
+                done ? 1000.0 * (after.totalLatencySeconds - before.totalLatencySeconds) / static_cast<double>(done) : 0.0);
+}
+
+void RunContexts(FakePapyrusVM& vm, std::span<const RE::FormID> targets, std::int32_t operations) {
+    auto& manager = ScriptContextManager::GetSingleton();
+    auto script = MakeLoopScript(operations);
+    const auto before = vm.GetStats();
+
+    const auto start = Clock::now();
+    std::uint64_t started = 0;
+    for (auto target : targets) {
+        started += manager.Start(target, 1, script) != 0;
+    }
+
+    std::int32_t frames = 0;
+    for (; frames < 100000 && manager.RunningCount() > 0; ++frames) {
+        Frame(vm);
+    }
+    const auto elapsed = Clock::now() - start;
+
+    const auto after = vm.GetStats();
+    const auto dispatched = after.completed - before.completed;
+    const auto expected = started * static_cast<std::uint64_t>(operations);
+    Check(started == targets.size(), "contexts started", targets.size(), started);
+    Check(manager.RunningCount() == 0, "contexts finished", 0, manager.RunningCount());
+    Check(dispatched == expected, "context dispatches", expected, dispatched);
+
+    std::printf("ScriptContext:      %llu contexts x %d operations, %.3f us per operation, %.2f s simulated to finish\n",
+                static_cast<unsigned long long>(started), operations, Micros(elapsed) / static_cast<double>(dispatched ? dispatched : 1),
+                frames * kFrameSeconds);
+}
+}
+
+int main(int argc, char** argv) {
+    spdlog::set_level(spdlog::level::off);
+
+    const std::size_t targetCount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+    const std::int32_t operations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 50;
+
+    FakePapyrusVM vm({ .dispatchLatencySeconds = 0.05f, .effectSeconds = 600.0f });
+    PapyrusVM::SetInstance(&vm);
+    vm.DefineScript(kLibrary, { "op_a", "op_b" });
+    FunctionLibrary::functionScriptCache["op_a"] = std::string(kLibrary);
+    FunctionLibrary::functionScriptCache["op_b"] = std::string(kLibrary);
+
+    std::vector<RE::FormID> spells;
+    std::vector<RE::FormID> effects;
+    for (std::size_t i = 0; i < kPoolSize; ++i) {
+        spells.push_back(static_cast<RE::FormID>(0xFF000100 + i));
+        effects.push_back(static_cast<RE::FormID>(0xFF000200 + i));
+    }
+    vm.DefineSpellEffects(spells, effects);
+    ScriptPoolManager::GetSingleton().InitializePool(std::move(spells), std::move(effects));
+
+    // from here on queued work waits for Frame, as it would for the main-loop hook
+    MainThreadQueue::GetSingleton().RunFrame();
+
+    std::vector<RE::FormID> targets;
+    for (std::size_t i = 0; i < targetCount; ++i) {
+        targets.push_back(kFirstTarget + static_cast<RE::FormID>(i));
+    }
+
+    RunBatch(vm, targets);
+    RunDispatches(vm, targets, operations);
+    RunContexts(vm, targets, operations);
+
+    PapyrusVM::SetInstance(nullptr);
+    if (failures > 0) {
+        std::printf("%d native throughput checks failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
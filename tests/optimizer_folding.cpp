@@ -0,0 +1,119 @@
+// Checks that ScriptOptimizer only folds what the Papyrus side would decide the same way: an
+// if comparing two literals with ==, = or != must resolve exactly as the SmartEquals native does,
+// and arithmetic, ordering and anything with a variable or bare word must be left alone.
+
+#include "expression.h"
+#include "optimizer.h"
+#include "sl_triggers.h"
+
+#include <cstdio>
+
+namespace {
+using namespace SLT;
+
+int failures = 0;
+
+void Check(bool ok, std::string_view what, std::string_view detail) {
+    if (!ok) {
+        failures++;
+        std::printf("FAIL %.*s: %.*s\n", static_cast<int>(what.size()), what.data(), static_cast<int>(detail.size()), detail.data());
+    }
+}
+
+LoadedScript MakeScript(std::initializer_list<std::string_view> source) {
+    LoadedScript script;
+    script.name = "folding.sltscript";
+    std::int32_t lineNo = 0;
+    for (auto text : source) {
+        auto& line = script.lines.emplace_back();
+        line.lineNo = ++lineNo;
+        line.tokens = SLTNativeFunctions::Tokenizev2(nullptr, 0, text);
+        line.slots.assign(line.tokens.size(), NO_SLOT);
+    }
+    ScriptLibrary::BuildControlFlow(script);
+    return script;
+}
+
+bool HasCommand(const LoadedScript& script, std::string_view cmd) {
+    return std::ranges::any_of(script.lines, [cmd](const ScriptLine& line) { return str::iEquals(line.tokens[0], cmd); });
+}
+
+void CheckComparisons() {
+    const std::pair<std::string_view, std::string_view> pairs[] = {
+        { "abc", "abc" }, { "abc", "ABC" }, { "", "" }, { "", "0" }, { "0", "false" }, { "1", "1.0" },
+        { "0x10", "16" }, { "05", "5" }, { "1e3", "1000" }, { "1.1", "1.1000001" }, { "true", "True" }, { "-0", "0" },
+    };
+
+    for (const auto& [a, b] : pairs) {
+        for (std::string_view op : { "==", "=", "!=" }) {
+            const bool expected = SLTNativeFunctions::SmartEquals(nullptr, 0, a, b) != (op == "!=");
+            const auto detail = std::format("'{}' {} '{}'", a, op, b);
+
+            const auto quoted = std::format("if \"{}\" {} \"{}\"", a, op, b);
+            auto optimized = ScriptOptimizer::Optimize(MakeScript({ quoted, "set $r 1", "endif" }));
+            Check(optimized != nullptr, "quoted folded", detail);
+            if (optimized) {
+                Check(HasCommand(*optimized, "set") == expected, "quoted if/endif", detail);
+            }
+
+            const auto jump = std::format("if \"{}\" {} \"{}\" [yes]", a, op, b);
+            optimized = ScriptOptimizer::Optimize(MakeScript({ jump, "set $r 1", "[yes]" }));
+            Check(optimized != nullptr, "jump folded", detail);
+            if (optimized) {
+                Check(HasCommand(*optimized, "goto") == expected, "jump form if", detail);
+            }
+
+            // bare operands are only folded when both are numbers
+            if (!a.empty() && !b.empty()) {
+                const bool numbers = std::ranges::all_of(std::array{ a, b }, [](std::string_view s) {
+                    auto value = ExprValueFromString(s);
+                    return std::holds_alternative<std::int32_t>(value) || std::holds_alternative<float>(value);
+                });
+                const auto bare = std::format("if {} {} {}", a, op, b);
+                optimized = ScriptOptimizer::Optimize(MakeScript({ bare, "set $r 1", "endif" }));
+                Check((optimized != nullptr) == numbers, "bare folded", detail);
+                if (optimized) {
+                    Check(HasCommand(*optimized, "set") == expected, "bare if/endif", detail);
+                }
+            }
+        }
+    }
+}
+
+void CheckLeftAlone() {
+    const std::initializer_list<std::string_view> scripts[] = {
+        { "set $x 7 / 2" },
+        { "set $x 1 + 2" },
+        { "set $x \"a\" == \"a\"" },
+        { "if 1 < 2", "set $r 1", "endif" },
+        { "if 1 + 1 == 2", "set $r 1", "endif" },
+        { "if \"a\" == \"a\" && 1", "set $r 1", "endif" },
+        { "if $x == 1", "set $r 1", "endif" },
+        { "if abc == abc", "set $r 1", "endif" },
+        { "if \"a\"\"b\" == \"a\"\"b\"", "set $r 1", "endif" },
+        { "while 1 < 0", "set $r 1", "endwhile" },
+    };
+
+    for (const auto& source : scripts) {
+        Check(ScriptOptimizer::Optimize(MakeScript(source)) == nullptr, "left alone", *source.begin());
+    }
+
+    // a false literal comparison removes the loop
+    auto optimized = ScriptOptimizer::Optimize(MakeScript({ "while 0 == 1", "set $r 1", "endwhile" }));
+    Check(optimized && optimized->lines.empty(), "while folded", "while 0 == 1");
+}
+}
+
+int main() {
+    spdlog::set_level(spdlog::level::off);
+
+    CheckComparisons();
+    CheckLeftAlone();
+
+    if (failures > 0) {
+        std::printf("%d optimizer folding checks failed\n", failures);
+        return 1;
+    }
+    std::printf("optimizer folding: ok\n");
+    return 0;
+}
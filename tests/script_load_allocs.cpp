@@ -0,0 +1,219 @@
+// Counts the heap allocations it takes to load every script in a directory, once through the
+// line-by-line pipeline the loader used before its per-load arena and once through
+// ScriptLibrary::Parse. Every operator new is counted; the pmr default resource is a counting
+// resource too, so what the arena spills past its thread-local block is also reported on its own.
+//
+//   script_load_allocs [scripts directory] [passes]
+//
+// The directory defaults to the plugin's commands folder under the working directory. Each
+// pipeline gets one untimed pass first, so thread-local buffers and caches are warm and the
+// figures are what a load costs in a running session.
+
+#include "script.h"
+#include "sl_triggers.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> heapAllocations = 0;
+std::atomic<std::uint64_t> heapBytes = 0;
+}
+
+void* operator new(std::size_t size) {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    heapBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+using namespace SLT;
+
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::uint64_t allocations = 0;
+
+private:
+    void* do_allocate(std::size_t size, std::size_t alignment) override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t size, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// ScriptLibrary::Load as it was before the arena: std::getline per line, trimmed and cut into
+// owning strings, tokenized into owning strings (today's tokenizer through its Papyrus entry
+// point, which returns the same std::vector<std::string> the old one did) and a heap block stack
+std::shared_ptr<LoadedScript> ParseLineByLine(std::string_view scriptfilename, const fs::path& filepath) {
+    std::ifstream file(filepath);
+    if (!file.good()) {
+        return nullptr;
+    }
+
+    auto script = std::make_shared<LoadedScript>();
+    script->name = std::string(scriptfilename);
+
+    std::error_code ec;
+    script->lastWriteTime = fs::last_write_time(filepath, ec);
+
+    auto assignSlot = [&script](std::string_view varName) -> std::int32_t {
+        if (!ScriptLibrary::IsSlottedVariable(varName)) {
+            return NO_SLOT;
+        }
+        auto [it, inserted] = script->slotIndex.try_emplace(std::string(varName), script->SlotCount());
+        if (inserted) {
+            script->slotNames.emplace_back(varName);
+        }
+        return it->second;
+    };
+
+    std::int32_t lineno = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        lineno++;
+
+        line = Util::String::truncateAt(Util::String::trim(line), ';');
+
+        auto linetokens = SLTNativeFunctions::Tokenizev2(nullptr, 0, line);
+        if (linetokens.empty()) {
+            continue;
+        }
+
+        ScriptLine& scriptLine = script->lines.emplace_back();
+        scriptLine.lineNo = lineno;
+        scriptLine.slots.reserve(linetokens.size());
+
+        for (const auto& token : linetokens) {
+            std::int32_t slot = NO_SLOT;
+            if (token.size() > 1 && token[0] == '$') {
+                if (token[1] == '"') {
+                    for (const auto& piece : SLTNativeFunctions::TokenizeForVariableSubstitution(std::string_view(token).substr(2))) {
+                        if (piece.isVariable) {
+                            assignSlot(piece.text);
+                        }
+                    }
+                } else {
+                    slot = assignSlot(std::string_view(token).substr(1));
+                }
+            }
+            scriptLine.slots.push_back(slot);
+        }
+        scriptLine.tokens = std::move(linetokens);
+    }
+
+    ScriptLibrary::BuildControlFlow(*script);
+    return script;
+}
+
+using ParseFn = std::shared_ptr<LoadedScript> (*)(std::string_view, const fs::path&);
+
+struct Sample {
+    std::uint64_t loads = 0;
+    std::uint64_t lines = 0;
+    std::uint64_t heapAllocations = 0;
+    std::uint64_t heapBytes = 0;
+    std::uint64_t pmrAllocations = 0;
+    double seconds = 0.0;
+};
+
+Sample Measure(ParseFn parse, const std::vector<fs::path>& files, std::size_t passes, CountingResource& pmr) {
+    Sample sample;
+    const auto allocationsBefore = heapAllocations.load();
+    const auto bytesBefore = heapBytes.load();
+    const auto pmrBefore = pmr.allocations;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        for (const auto& file : files) {
+            if (auto script = parse(file.filename().string(), file)) {
+                sample.loads++;
+                sample.lines += script->lines.size();
+            }
+        }
+    }
+
+    sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sample.heapAllocations = heapAllocations.load() - allocationsBefore;
+    sample.heapBytes = heapBytes.load() - bytesBefore;
+    sample.pmrAllocations = pmr.allocations - pmrBefore;
+    return sample;
+}
+
+void Report(const char* name, const Sample& sample) {
+    const double loads = static_cast<double>(std::max<std::uint64_t>(sample.loads, 1));
+    std::printf("%-14s %8.1f allocs/load %10.1f bytes/load %8.1f pmr upstream/load %8.2f allocs/line %8.1f us/load\n", name,
+                sample.heapAllocations / loads, sample.heapBytes / loads, sample.pmrAllocations / loads,
+                sample.heapAllocations / static_cast<double>(std::max<std::uint64_t>(sample.lines, 1)), sample.seconds * 1e6 / loads);
+}
+}
+
+int main(int argc, char** argv) {
+    const fs::path directory = argc > 1 ? fs::path(argv[1]) : GetPluginPath() / "commands";
+    const std::size_t passes = argc > 2 ? static_cast<std::size_t>(std::max(1, std::atoi(argv[2]))) : 20;
+
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        const auto extension = it->path().extension().string();
+        if (it->is_regular_file() && (str::iEquals(extension, ".sltscript") || str::iEquals(extension, ".ini"))) {
+            files.push_back(it->path());
+        }
+    }
+    if (ec || files.empty()) {
+        std::printf("no scripts found in %s\n", directory.string().c_str());
+        return 1;
+    }
+    std::ranges::sort(files);
+
+    // load diagnostics would only add their own allocations and noise
+    spdlog::set_level(spdlog::level::off);
+
+    CountingResource pmr;
+    std::pmr::set_default_resource(&pmr);
+
+    Measure(&ParseLineByLine, files, 1, pmr);
+    const auto before = Measure(&ParseLineByLine, files, passes, pmr);
+    Measure(&ScriptLibrary::Parse, files, 1, pmr);
+    const auto after = Measure(&ScriptLibrary::Parse, files, passes, pmr);
+
+    std::pmr::set_default_resource(nullptr);
+
+    std::printf("%zu scripts, %llu functional lines, %zu passes\n", files.size(),
+                static_cast<unsigned long long>(after.lines / passes), passes);
+    Report("line-by-line", before);
+    Report("arena", after);
+    return 0;
+}